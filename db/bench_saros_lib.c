@@ -0,0 +1,444 @@
+/*
+ * bench_saros_lib.c — Lookup throughput of saros.h on random timestamps.
+ *
+ * Build and run (from db/):
+ *   make bench
+ * which builds this file five times against the "all" slice — with the
+ * default search kernels, with -DSAROS_NO_SIMD, with -DSAROS_PACKED_TIMES,
+ * with -DSAROS_INFO_COLUMNS and with the class, duration and geo indexes —
+ * and runs each.
+ * Compare the ns/query columns to see what a search variant buys.
+ * Add -DSAROS_BATCH_GROUP=<n> to CFLAGS to try other batch group sizes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <inttypes.h>
+#include <math.h>
+
+#include "saros.h"
+
+#define BENCH_QUERIES  2000000u
+#define BENCH_ROUNDS   3u
+#define BENCH_PLACES   20000u     /* find_solar_eclipses_near() queries */
+#define BENCH_NEAR_KM  1000.0
+
+/* ── Helpers ────────────────────────────────────────────────────────────── */
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* xorshift64 — deterministic, so every build sees the same queries */
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* Uniform timestamps over [first, last] of the dataset. */
+static void fill_queries(int64_t *q, uint32_t n, int64_t first, int64_t last)
+{
+    uint64_t span = (uint64_t)(last - first) + 1u;
+    for (uint32_t i = 0; i < n; i++)
+        q[i] = first + (int64_t)(rng_next() % span);
+}
+
+typedef eclipse_result_t (*lookup_fn)(int64_t);
+
+/* Best-of-N ns/query; the checksum keeps the calls from being optimised out. */
+static double bench_lookup(lookup_fn fn, const int64_t *q, uint32_t n,
+                           uint64_t *checksum)
+{
+    double best = 0.0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < n; i++)
+            *checksum += fn(q[i]).eclipse.global_index;
+        double dt = (now_ns() - t0) / n;
+        if (round == 0 || dt < best)
+            best = dt;
+    }
+    return best;
+}
+
+typedef void (*batch_fn)(const int64_t *, size_t, eclipse_result_t *);
+
+/* Best-of-N ns/query for a batch call over all of q. */
+static double bench_batch(batch_fn fn, const int64_t *q, uint32_t n,
+                          eclipse_result_t *out, uint64_t *checksum)
+{
+    double best = 0.0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        double t0 = now_ns();
+        fn(q, n, out);
+        double dt = (now_ns() - t0) / n;
+        *checksum += out[n / 2u].eclipse.global_index;
+        if (round == 0 || dt < best)
+            best = dt;
+    }
+    return best;
+}
+
+/* One-at-a-time baseline with the same output traffic as a batch call. */
+static lookup_fn loop_lookup;
+
+static void loop_batch(const int64_t *q, size_t n, eclipse_result_t *out)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = loop_lookup(q[i]);
+}
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+typedef uint32_t        (*index_fn)(int64_t);
+typedef int64_t         (*time_fn)(uint32_t);
+typedef eclipse_range_t (*range_fn)(int64_t, int64_t);
+typedef int             (*range_next_fn)(eclipse_range_t *);
+typedef eclipse_entry_t (*range_entry_fn)(const eclipse_range_t *);
+typedef uint8_t         (*type_fn)(uint32_t);
+typedef int             (*range_next_of_fn)(eclipse_range_t *, uint32_t);
+typedef eclipse_result_t (*lookup_of_fn)(int64_t, uint32_t);
+typedef eclipse_result_t (*lookup_dur_fn)(int64_t, uint16_t);
+typedef uint16_t        (*duration_fn)(const eclipse_entry_t *);
+
+/* The API of one eclipse kind. */
+typedef struct {
+    const char     *name;
+    lookup_fn       next, past, closest;
+    batch_fn        next_batch;
+    index_fn        next_index;
+    time_fn         time;
+    range_fn        range;
+    range_next_fn   range_next;
+    range_entry_fn  range_entry;
+    type_fn         type;
+    range_next_of_fn range_next_of;
+    lookup_of_fn    next_of;
+    uint32_t        scan_mask;    /* types wanted by bench_scan / bench_of */
+    lookup_dur_fn   next_min_duration;
+    duration_fn     duration;     /* the field next_min_duration tests */
+    uint16_t        min_secs;
+} kind_api_t;
+
+/* Best-of-N ns/query for an index lookup that reads back just the time. */
+static double bench_index(const kind_api_t *k, const int64_t *q, uint32_t n,
+                          uint64_t *checksum)
+{
+    double best = 0.0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t idx = k->next_index(q[i]);
+            if (idx != SAROS_NO_ECLIPSE)
+                *checksum += (uint64_t)k->time(idx);
+        }
+        double dt = (now_ns() - t0) / n;
+        if (round == 0 || dt < best)
+            best = dt;
+    }
+    return best;
+}
+
+/* ns/eclipse to list every eclipse in [first, last]: chained find_next vs. iterator. */
+static void bench_table(const kind_api_t *k, int64_t first, int64_t last)
+{
+    double best_chain = 0.0, best_iter = 0.0;
+    uint64_t sum = 0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        uint32_t n = 0;
+        double t0 = now_ns();
+        for (eclipse_result_t r = k->next(first);
+             r.eclipse.valid && r.eclipse.unix_time <= last;
+             r = k->next(r.eclipse.unix_time + 1), n++)
+            sum += r.eclipse.info.solar.saros_number;
+        double chain = (now_ns() - t0) / n;
+
+        t0 = now_ns();
+        eclipse_range_t it = k->range(first, last + 1);
+        while (k->range_next(&it))
+            sum += k->range_entry(&it).info.solar.saros_number;
+        double iter = (now_ns() - t0) / n;
+
+        if (round == 0 || chain < best_chain) best_chain = chain;
+        if (round == 0 || iter  < best_iter)  best_iter  = iter;
+    }
+    printf("  %-6s  table:  find_next chain %7.1f ns/eclipse  range %7.1f ns/eclipse"
+           "   (checksum %" PRIu64 ")\n", k->name, best_chain, best_iter, sum);
+}
+
+/* ns/query for "next eclipse of k->scan_mask": find_next loop vs. find_next_of. */
+static void bench_of(const kind_api_t *k, const int64_t *q, uint32_t n)
+{
+    double best_loop = 0.0, best_of = 0.0;
+    uint64_t sum = 0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            eclipse_result_t r = k->next(q[i]);
+            while (r.eclipse.valid &&
+                   !(k->scan_mask & SAROS_TYPE_BIT(r.eclipse.info.solar.ecl_type)))
+                r = k->next(r.eclipse.unix_time + 1);
+            sum += r.eclipse.global_index;
+        }
+        double loop = (now_ns() - t0) / n;
+
+        t0 = now_ns();
+        for (uint32_t i = 0; i < n; i++)
+            sum += k->next_of(q[i], k->scan_mask).eclipse.global_index;
+        double of = (now_ns() - t0) / n;
+
+        if (round == 0 || loop < best_loop) best_loop = loop;
+        if (round == 0 || of   < best_of)   best_of   = of;
+    }
+    printf("  %-6s  filtered: find_next loop %7.1f ns/query   find_next_of %7.1f ns/query"
+           "   (checksum %" PRIu64 ")\n", k->name, best_loop, best_of, sum);
+}
+
+/* ns/query for "next eclipse lasting >= k->min_secs": find_next loop vs. index. */
+static void bench_min_duration(const kind_api_t *k, const int64_t *q, uint32_t n)
+{
+    double best_loop = 0.0, best_idx = 0.0;
+    uint64_t sum = 0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            eclipse_result_t r = k->next(q[i]);
+            while (r.eclipse.valid && (k->duration(&r.eclipse) == 0xFFFFu ||
+                                       k->duration(&r.eclipse) < k->min_secs))
+                r = k->next(r.eclipse.unix_time + 1);
+            sum += r.eclipse.global_index;
+        }
+        double loop = (now_ns() - t0) / n;
+
+        t0 = now_ns();
+        for (uint32_t i = 0; i < n; i++)
+            sum += k->next_min_duration(q[i], k->min_secs).eclipse.global_index;
+        double idx = (now_ns() - t0) / n;
+
+        if (round == 0 || loop < best_loop) best_loop = loop;
+        if (round == 0 || idx  < best_idx)  best_idx  = idx;
+    }
+    printf("  %-6s  >= %us: find_next loop %8.1f ns/query   _min_duration %7.1f ns/query"
+           "   (checksum %" PRIu64 ")\n", k->name, (unsigned)k->min_secs,
+           best_loop, best_idx, sum);
+}
+
+/* ns/eclipse to find every eclipse of k->scan_mask in the catalog. */
+static void bench_scan(const kind_api_t *k)
+{
+    double best_test = 0.0, best_of = 0.0;
+    uint32_t hits = 0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        uint32_t n = 0, h = 0;
+        double t0 = now_ns();
+        eclipse_range_t r = k->range(INT64_MIN, INT64_MAX);
+        while (k->range_next(&r)) {
+            h += (k->scan_mask & SAROS_TYPE_BIT(k->type(r.index))) != 0u;
+            n++;
+        }
+        double test = (now_ns() - t0) / n;
+
+        hits = 0;
+        t0 = now_ns();
+        r = k->range(INT64_MIN, INT64_MAX);
+        while (k->range_next_of(&r, k->scan_mask))
+            hits++;
+        double of = (now_ns() - t0) / n;
+
+        if (h != hits)
+            printf("  %-6s  scan: MISMATCH %u vs %u\n", k->name, h, hits);
+        if (round == 0 || test < best_test) best_test = test;
+        if (round == 0 || of   < best_of)   best_of   = of;
+    }
+    printf("  %-6s  scan:   range_next + type %5.2f ns/eclipse  range_next_of %5.2f ns/eclipse"
+           "   (%u matches)\n", k->name, best_test, best_of, hits);
+}
+
+static void bench_kind(const kind_api_t *k, int64_t *q, uint32_t n,
+                       eclipse_result_t *out)
+{
+    int64_t first = k->next(INT64_MIN).eclipse.unix_time;
+    int64_t last  = k->past(INT64_MAX).eclipse.unix_time;
+    fill_queries(q, n, first, last);
+
+    uint64_t sum = 0;
+    double ns_next = bench_lookup(k->next, q, n, &sum);
+    double ns_past = bench_lookup(k->past, q, n, &sum);
+    double ns_clos = bench_lookup(k->closest, q, n, &sum);
+    printf("  %-6s  find_next %7.1f ns/query   find_past %7.1f ns/query"
+           "   find_closest %7.1f ns/query   (checksum %" PRIu64 ")\n",
+           k->name, ns_next, ns_past, ns_clos, sum);
+
+    sum = 0;
+    double ns_index = bench_index(k, q, n, &sum);
+    printf("  %-6s  find_next_index + time %7.1f ns/query"
+           "   (checksum %" PRIu64 ")\n", k->name, ns_index, sum);
+    bench_of(k, q, n);
+    bench_min_duration(k, q, n / 16u);
+
+    sum = 0;
+    loop_lookup = k->next;
+    double ns_rloop  = bench_batch(loop_batch, q, n, out, &sum);
+    double ns_rbatch = bench_batch(k->next_batch, q, n, out, &sum);
+    printf("  %-6s  random: find_next loop %7.1f ns/query   _batch %7.1f ns/query"
+           "   (checksum %" PRIu64 ")\n", k->name, ns_rloop, ns_rbatch, sum);
+
+    qsort(q, n, sizeof(*q), cmp_i64);
+    sum = 0;
+    double ns_loop  = bench_batch(loop_batch, q, n, out, &sum);
+    double ns_batch = bench_batch(k->next_batch, q, n, out, &sum);
+    printf("  %-6s  sorted: find_next loop %7.1f ns/query   _batch %7.1f ns/query"
+           "   (checksum %" PRIu64 ")\n", k->name, ns_loop, ns_batch, sum);
+
+    bench_table(k, first, last);
+    bench_scan(k);
+}
+
+#ifdef SAROS_USE_GEO_INDEX
+static int count_near(uint32_t idx, double distance_km, void *user)
+{
+    (void)distance_km;
+    *(uint64_t *)user += idx;
+    return 0;
+}
+
+/* ns/query for "solar eclipses within BENCH_NEAR_KM of a random place", whole catalog
+ * (find_solar_eclipses_near() is only built with SAROS_USE_GEO_INDEX). */
+static void bench_near(void)
+{
+    static double lat[BENCH_PLACES], lon[BENCH_PLACES];
+    for (uint32_t i = 0; i < BENCH_PLACES; i++) {
+        /* uniform on the sphere */
+        double u = (double)(rng_next() >> 11) / 9007199254740992.0;
+        lat[i] = asin(2.0 * u - 1.0) * (180.0 / 3.14159265358979323846);
+        lon[i] = (double)(rng_next() % 3600u) / 10.0 - 180.0;
+    }
+    double best = 0.0;
+    uint64_t sum = 0, hits = 0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        hits = 0;
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < BENCH_PLACES; i++)
+            hits += find_solar_eclipses_near(lat[i], lon[i], BENCH_NEAR_KM,
+                                             INT64_MIN, INT64_MAX, count_near, &sum);
+        double dt = (now_ns() - t0) / BENCH_PLACES;
+        if (round == 0 || dt < best)
+            best = dt;
+    }
+    printf("  solar   near:   %.0f km, all years %9.1f ns/query   (%.1f eclipses/query,"
+           " checksum %" PRIu64 ")\n", BENCH_NEAR_KM, best,
+           (double)hits / BENCH_PLACES, sum);
+}
+#endif
+
+static uint8_t solar_type(uint32_t idx) { return (uint8_t)saros_solar_type(idx); }
+static uint8_t lunar_type(uint32_t idx) { return (uint8_t)saros_lunar_type(idx); }
+
+static uint16_t solar_central(const eclipse_entry_t *e) { return e->info.solar.central_duration; }
+static uint16_t lunar_total(const eclipse_entry_t *e)   { return e->info.lunar.total_duration; }
+
+static eclipse_result_t lunar_next_total(int64_t ts, uint16_t secs)
+{
+    return find_next_lunar_eclipse_min_duration(ts, LUNAR_PHASE_TOTAL, secs);
+}
+
+/* Next eclipse of either kind the way a caller without the merged API gets
+ * it: a full lookup per kind, keep the earlier. */
+static eclipse_result_t next_by_hand(int64_t ts)
+{
+    eclipse_result_t s = find_next_solar_eclipse(ts);
+    eclipse_result_t l = find_next_lunar_eclipse(ts);
+    return (l.eclipse.valid && (!s.eclipse.valid || l.eclipse.unix_time < s.eclipse.unix_time))
+           ? l : s;
+}
+
+static eclipse_result_t next_any(int64_t ts)
+{
+    return find_next_eclipse_any(ts).result;
+}
+
+static void bench_any(int64_t *q, uint32_t n)
+{
+    fill_queries(q, n, find_next_solar_eclipse(INT64_MIN).eclipse.unix_time,
+                 find_past_solar_eclipse(INT64_MAX).eclipse.unix_time);
+    uint64_t sum = 0;
+    double ns_hand = bench_lookup(next_by_hand, q, n, &sum);
+    double ns_any  = bench_lookup(next_any, q, n, &sum);
+    printf("  both    find_next solar + lunar %7.1f ns/query   find_next_eclipse_any %7.1f ns/query"
+           "   (checksum %" PRIu64 ")\n", ns_hand, ns_any, sum);
+
+    double best = 0.0;
+    uint32_t count = 0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        uint32_t c = 0;
+        double t0 = now_ns();
+        eclipse_timeline_t tl = eclipse_timeline(INT64_MIN, INT64_MAX);
+        while (eclipse_timeline_next(&tl)) {
+            sum += tl.index;
+            c++;
+        }
+        double dt = (now_ns() - t0) / c;
+        if (round == 0 || dt < best)
+            best = dt;
+        count = c;
+    }
+    printf("  both    scan:   eclipse_timeline_next %5.2f ns/eclipse   (%u eclipses,"
+           " checksum %" PRIu64 ")\n", best, count, sum);
+}
+
+/* ── Main ───────────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    int64_t          *q   = malloc(BENCH_QUERIES * sizeof(*q));
+    eclipse_result_t *out = malloc(BENCH_QUERIES * sizeof(*out));
+    if (!q || !out) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("%s — %u random timestamps, best of %u rounds\n",
+           argv[0], BENCH_QUERIES, BENCH_ROUNDS);
+    static const kind_api_t solar = {
+        "solar", find_next_solar_eclipse, find_past_solar_eclipse,
+        find_closest_solar_eclipse, find_next_solar_eclipse_batch,
+        find_next_solar_index, saros_solar_time,
+        solar_eclipse_range, solar_range_next, solar_range_entry,
+        solar_type, solar_range_next_of, find_next_solar_eclipse_of,
+        SOLAR_TYPES_TOTAL,
+        find_next_solar_eclipse_min_duration, solar_central, 4u * 60u,
+    };
+    static const kind_api_t lunar = {
+        "lunar", find_next_lunar_eclipse, find_past_lunar_eclipse,
+        find_closest_lunar_eclipse, find_next_lunar_eclipse_batch,
+        find_next_lunar_index, saros_lunar_time,
+        lunar_eclipse_range, lunar_range_next, lunar_range_entry,
+        lunar_type, lunar_range_next_of, find_next_lunar_eclipse_of,
+        LUNAR_TYPES_TOTAL,
+        lunar_next_total, lunar_total, 90u * 60u,
+    };
+    bench_kind(&solar, q, BENCH_QUERIES, out);
+#ifdef SAROS_USE_GEO_INDEX
+    bench_near();
+#endif
+    bench_kind(&lunar, q, BENCH_QUERIES, out);
+    bench_any(q, BENCH_QUERIES);
+
+    free(out);
+    free(q);
+    return 0;
+}
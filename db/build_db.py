@@ -6,14 +6,64 @@ Outputs (written to the same db/ directory this script lives in):
   solar/
     eclipse_times.db  — sorted int64 timestamps, one per solar eclipse
     eclipse_info.db   — 10-byte packed records, one per solar eclipse (same order)
-    saros.db          — 174-byte records, one per saros series (indexed by saros_number - 1)
+    saros_offsets.db / saros_members.db / prev_in_series.db / next_in_series.db
+                      — the arrays of saros_all.h, for saros_db_open()
     eclipse_times_<label>.h / eclipse_info_<label>.h / saros_<label>.h  (PROGMEM headers)
+      saros_<label>.h holds the series index (CSR offsets + members) and
+      the prev_in_series / next_in_series links
+    eclipse_times_packed_<label>.h  (optional compressed timestamps, SAROS_PACKED_TIMES)
+    eclipse_info_packed_<label>.h  (optional bit-packed info records, SAROS_PACKED_INFO)
+    eclipse_info_columns_<label>.h  (optional column-split info records, SAROS_INFO_COLUMNS)
+    eclipse_class_<label>.h  (optional per-class type bitmaps, SAROS_USE_CLASS_INDEX)
+    eclipse_dmax_<label>.h  (optional duration range-max trees, SAROS_USE_DURATION_INDEX)
+    eclipse_geo_<label>.h  (optional lat/lon grid of greatest-eclipse points, SAROS_USE_GEO_INDEX)
+    eclipse_eytz_<label>.h  (optional Eytzinger search layout, SAROS_LAYOUT_EYTZINGER)
+    eclipse_bucket_<label>.h  (optional bucketed time index, SAROS_USE_BUCKET_INDEX)
 
   lunar/
     eclipse_times.db  — sorted int64 timestamps, one per lunar eclipse
     eclipse_info.db   — 10-byte packed records, one per lunar eclipse (same order)
-    saros.db          — 174-byte records, one per saros series (indexed by saros_number - 1)
+    saros_offsets.db / saros_members.db / prev_in_series.db / next_in_series.db
+                      — the arrays of saros_all.h, for saros_db_open()
     eclipse_times_<label>.h / eclipse_info_<label>.h / saros_<label>.h  (PROGMEM headers)
+      saros_<label>.h holds the series index (CSR offsets + members) and
+      the prev_in_series / next_in_series links
+    eclipse_times_packed_<label>.h  (optional compressed timestamps, SAROS_PACKED_TIMES)
+    eclipse_info_packed_<label>.h  (optional bit-packed info records, SAROS_PACKED_INFO)
+    eclipse_info_columns_<label>.h  (optional column-split info records, SAROS_INFO_COLUMNS)
+    eclipse_class_<label>.h  (optional per-class type bitmaps, SAROS_USE_CLASS_INDEX)
+    eclipse_dmax_<label>.h  (optional duration range-max trees, SAROS_USE_DURATION_INDEX)
+    eclipse_eytz_<label>.h  (optional Eytzinger search layout, SAROS_LAYOUT_EYTZINGER)
+    eclipse_bucket_<label>.h  (optional bucketed time index, SAROS_USE_BUCKET_INDEX)
+
+  eclipses.sdb         — container: the .db arrays saros_db_open() reads, of
+                         both kinds, plus the class, duration and geo indexes,
+                         in one file (below)
+
+The .db files and the container hold the full catalog and are read at run
+time by saros_db_open() (db_impl.c); the headers are compiled in.
+
+eclipses.sdb is little-endian and self-describing: a 64-byte header, a
+section table, then the sections, each starting at a multiple of 64 bytes
+so that it can be used in place once the file is mapped.
+  header   [0-7]   magic "SAROSDB\0"     [8-9]   uint16 version (2)
+           [10-11] uint16 header size    [12-13] uint16 section count
+           [14-15] uint16 entry size     [16-23] uint64 file size
+           [24-27] uint32 CRC32C of the header (this field zeroed) + table
+           [32+8k] per kind k (0 solar, 1 lunar): uint32 count,
+                   uint8 saros_first, uint8 saros_last, uint16 0
+  section  [0] uint8 kind  [1] uint8 id (SECTION_*)  [4-7] uint32 CRC32C
+           [8-15] uint64 offset  [16-23] uint64 size
+           [24-27] uint32 param (dmax: leaves per tree, geo offsets: cell)
+The sections hold the bytes of the matching "all" header arrays, the series
+index and links included (offsets for series 1-180), so nothing needs to be
+rebuilt once the file is mapped.  CRC32C is the Castagnoli CRC (reflected
+0x82F63B78).
+
+Every generated symbol carries the kind, so solar and lunar headers can be
+included in one translation unit: arrays are named <kind>_<array>_<label>
+(e.g. solar_eclipse_times_modern[]) and macros <KIND>_ECLIPSE_<LABEL>_*
+(e.g. LUNAR_ECLIPSE_ALL_COUNT).
 
 Lunar eclipse_info_t layout differs from solar:
   [0-1] int16   pen_duration_s   (penumbral duration in seconds, 0xFFFF = n/a)
@@ -28,8 +78,10 @@ Run from any directory:
     python3 db/build_db.py           # build both solar and lunar
     python3 db/build_db.py solar     # build solar only
     python3 db/build_db.py lunar     # build lunar only
+    python3 db/build_db.py --bucket-shift 23   # finer time index (more flash)
 """
 
+import argparse
 import json
 import os
 import struct
@@ -52,6 +104,31 @@ LUNAR_ECL_TYPE_MAP = {
     "T":  7, "T+": 8, "T-": 9, "Tm":10, "Tn":11, "Ts":12,  # total
 }
 
+# Leaf block length of the eclipse_dmax_*.h range-max trees (must match
+# _SAROS_DMAX_BLOCK in saros.h)
+DURATION_MAX_BLOCK = 16
+
+# Cell size of the eclipse_geo_*.h grid in tenths of a degree (must divide
+# 1800; saros.h reads it from SOLAR_ECLIPSE_<LABEL>_GEO_CELL)
+GEO_CELL_DEG10 = 100
+
+# Type classes of eclipse_class_*.h, in bitmap order (must match
+# SOLAR_TYPES_* / LUNAR_TYPES_* and the class tables in saros.h)
+SOLAR_TYPE_CLASSES = (
+    ("annular", ("A", "A+", "A-", "Am", "An", "As")),
+    ("hybrid",  ("H", "H2", "H3", "Hm")),
+    ("partial", ("P", "Pb", "Pe")),
+    ("total",   ("T", "T+", "T-", "Tm", "Tn", "Ts")),
+)
+LUNAR_TYPE_CLASSES = (
+    ("penumbral", ("N", "Nb", "Ne", "Nx")),
+    ("partial",   ("P", "Pb", "Pe")),
+    ("total",     ("T", "T+", "T-", "Tm", "Tn", "Ts")),
+)
+for _classes, _types in ((SOLAR_TYPE_CLASSES, SOLAR_ECL_TYPE_MAP),
+                         (LUNAR_TYPE_CLASSES, LUNAR_ECL_TYPE_MAP)):
+    assert sorted(t for _, ts in _classes for t in ts) == sorted(_types)
+
 # ── Layout constants ─────────────────────────────────────────────────────────
 
 ECLIPSE_TIMES_RECORD = struct.Struct("<q")           # int64_t, 8 bytes
@@ -76,16 +153,77 @@ SOLAR_INFO_RECORD = struct.Struct("<hhHBBBB")        # 10 bytes
 # [9]   uint8   _pad
 LUNAR_INFO_RECORD = struct.Struct("<HHHBBBB")        # 10 bytes
 
-MAX_ECLIPSES_PER_SAROS = 96
-SAROS_ENTRY_RECORD = struct.Struct("<BB" + "H" * MAX_ECLIPSES_PER_SAROS)
-#   uint8  count
-#   uint8  _pad
-#   uint16 indices[96]
-# = 2 + 192 = 194 bytes
-
 assert SOLAR_INFO_RECORD.size == 10, f"Expected 10, got {SOLAR_INFO_RECORD.size}"
 assert LUNAR_INFO_RECORD.size == 10, f"Expected 10, got {LUNAR_INFO_RECORD.size}"
-assert SAROS_ENTRY_RECORD.size == 194, f"Expected 194, got {SAROS_ENTRY_RECORD.size}"
+
+# eclipses.sdb container (must match _SAROS_DB_* in saros.h)
+CONTAINER_NAME    = "eclipses.sdb"
+CONTAINER_MAGIC   = b"SAROSDB\0"
+CONTAINER_VERSION = 2
+CONTAINER_ALIGN   = 64
+CONTAINER_KINDS   = ("solar", "lunar")
+CONTAINER_HEADER  = struct.Struct("<8sHHHHQII" + "IBBH" * len(CONTAINER_KINDS) + "16x")
+CONTAINER_SECTION = struct.Struct("<BBHIQQII")
+(SECTION_TIMES, SECTION_INFO, SECTION_SAROS_OFFSETS, SECTION_SAROS_MEMBERS,
+ SECTION_PREV_IN_SERIES, SECTION_NEXT_IN_SERIES, SECTION_CLASS, SECTION_DMAX,
+ SECTION_GEO_OFFSETS, SECTION_GEO_MEMBERS) = range(1, 11)
+
+assert CONTAINER_HEADER.size == 64, f"Expected 64, got {CONTAINER_HEADER.size}"
+assert CONTAINER_SECTION.size == 32, f"Expected 32, got {CONTAINER_SECTION.size}"
+
+# prev_in_series / next_in_series entry for "no neighbour" (matches saros.h)
+SERIES_LINK_NONE = 0xFFFF
+
+# Run-time files of the series index, in saros_db_open()'s order (after
+# eclipse_times.db and eclipse_info.db)
+SERIES_DB_FILES = ("saros_offsets.db", "saros_members.db",
+                   "prev_in_series.db", "next_in_series.db")
+
+# Bucket width of the direct-address time index, as a power of two seconds.
+# 2^25 s ≈ 1.06 years ≈ 2.5 eclipses per bucket; lower it for fewer probes,
+# raise it for a smaller table.
+DEFAULT_BUCKET_SHIFT = 25
+
+# Block length of eclipse_times_packed_*.h (must match _SAROS_PACKED_BLOCK in saros.h)
+PACKED_TIMES_BLOCK = 16
+
+# Bit-packed eclipse_info_packed_*.h records: (name, bits, signed), LSB first.
+# Must match _decode_solar_packed / _decode_lunar_packed in saros.h.
+SOLAR_INFO_PACKED_SIZE = 8        # 60 bits used
+SOLAR_INFO_PACKED_FIELDS = (
+    ("saros_number",      8, False),
+    ("saros_pos",         7, False),
+    ("ecl_type",          5, False),
+    ("sun_alt",           7, False),
+    ("central_duration", 10, False),  # seconds, all ones = n/a
+    ("latitude_deg10",   11, True),
+    ("longitude_deg10",  12, True),
+)
+
+LUNAR_INFO_PACKED_SIZE = 7        # 54 bits used
+LUNAR_INFO_PACKED_FIELDS = (
+    ("saros_number",      8, False),
+    ("saros_pos",         7, False),
+    ("ecl_type",          4, False),
+    ("pen_duration",     12, False),  # 0.1 minute (6 s) units, all ones = n/a
+    ("par_duration",     12, False),
+    ("total_duration",   11, False),
+)
+LUNAR_DURATION_UNIT_S = 6
+
+# Column-split eclipse_info_columns_*.h: every field is its own column of
+# one value per eclipse.  The uint16 columns come first so they stay 2-byte
+# aligned; ecl_type / saros_number / saros_pos are at the same place for
+# both kinds.  Must match _SAROS_COL_* in saros.h.
+SOLAR_INFO_COLUMNS = (
+    ("latitude_deg10",   "h"), ("longitude_deg10",  "h"), ("central_duration", "H"),
+    ("ecl_type",         "B"), ("saros_number",     "B"), ("saros_pos",        "B"),
+    ("sun_alt",          "B"),
+)
+LUNAR_INFO_COLUMNS = (
+    ("pen_duration",     "H"), ("par_duration",     "H"), ("total_duration",   "H"),
+    ("ecl_type",         "B"), ("saros_number",     "B"), ("saros_pos",        "B"),
+)
 
 SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
 ROOT_DIR   = os.path.dirname(SCRIPT_DIR)  # parent of db/
@@ -151,6 +289,193 @@ def pack_lunar_info(e: dict) -> bytes:
     )
 
 
+def pack_bits(fields: tuple, values: tuple, size: int) -> bytes:
+    """Pack values LSB-first into the bit fields described by fields."""
+    word, shift = 0, 0
+    for (name, bits, signed), v in zip(fields, values):
+        lo, hi = (-(1 << (bits - 1)), (1 << (bits - 1)) - 1) if signed else (0, (1 << bits) - 1)
+        if not lo <= v <= hi:
+            raise ValueError(f"{name}={v} does not fit {bits} bits")
+        word |= (v & ((1 << bits) - 1)) << shift
+        shift += bits
+    return word.to_bytes(size, "little")
+
+
+def _packed_na(val: int, bits: int) -> int:
+    """Map the 0xFFFF "n/a" of a 10-byte record to all ones of a bit field."""
+    return (1 << bits) - 1 if val == 0xFFFF else val
+
+
+def pack_solar_info_packed(e: dict) -> bytes:
+    lat10, lon10, dur, saros_num, saros_pos, ecl_type, sun_alt = \
+        SOLAR_INFO_RECORD.unpack(pack_solar_info(e))
+    if dur != 0xFFFF and dur >= (1 << 10) - 1:
+        raise ValueError(f"central_duration={dur} s does not fit 10 bits")
+    return pack_bits(SOLAR_INFO_PACKED_FIELDS,
+                     (saros_num, saros_pos, ecl_type, sun_alt,
+                      _packed_na(dur, 10), lat10, lon10),
+                     SOLAR_INFO_PACKED_SIZE)
+
+
+def pack_lunar_info_packed(e: dict) -> bytes:
+    pen, par, total, saros_num, saros_pos, ecl_type, _ = \
+        LUNAR_INFO_RECORD.unpack(pack_lunar_info(e))
+    units = []
+    for (name, bits, _signed), secs in zip(LUNAR_INFO_PACKED_FIELDS[3:], (pen, par, total)):
+        if secs == 0xFFFF:
+            units.append((1 << bits) - 1)
+            continue
+        if secs % LUNAR_DURATION_UNIT_S:
+            raise ValueError(f"{name}={secs} s is not a whole number of 0.1 minutes")
+        if secs // LUNAR_DURATION_UNIT_S >= (1 << bits) - 1:
+            raise ValueError(f"{name}={secs} s does not fit {bits} bits")
+        units.append(secs // LUNAR_DURATION_UNIT_S)
+    return pack_bits(LUNAR_INFO_PACKED_FIELDS,
+                     (saros_num, saros_pos, ecl_type, *units),
+                     LUNAR_INFO_PACKED_SIZE)
+
+
+# ── Array builders ───────────────────────────────────────────────────────────
+# Each returns the bytes of one data array; the .db files, the container and
+# the headers all share them.
+
+def times_blob(eclipses: list[dict]) -> bytes:
+    return b"".join(ECLIPSE_TIMES_RECORD.pack(e["unix_timestamp"]) for e in eclipses)
+
+
+def info_blob(eclipses: list[dict], kind: str) -> bytes:
+    pack_info = pack_solar_info if kind == "solar" else pack_lunar_info
+    return b"".join(pack_info(e) for e in eclipses)
+
+
+def series_blobs(eclipses: list[dict], saros_start: int,
+                 saros_end: int) -> tuple[bytes, bytes, bytes, bytes]:
+    """saros_*.h: CSR offsets for series saros_start..saros_end and their
+    members, then the per-eclipse prev / next links (0xFFFF = none)."""
+    saros_local_map: dict[int, list[int]] = {}
+    for local_idx, e in enumerate(eclipses):
+        saros_local_map.setdefault(e["_saros_number"], []).append(local_idx)
+
+    # Compressed sparse rows: series s owns members[offsets[s]:offsets[s + 1]]
+    n = len(eclipses)
+    if n > 0xFFFE:
+        raise ValueError(f"{n} eclipses do not fit the uint16 series index")
+    offsets: list[int] = [0]
+    members: list[int] = []
+    for sn in range(saros_start, saros_end + 1):
+        members += saros_local_map.get(sn, [])
+        offsets.append(len(members))
+
+    # Per-eclipse links to the neighbours in the same series
+    prev_links = [SERIES_LINK_NONE] * n
+    next_links = [SERIES_LINK_NONE] * n
+    for indices in saros_local_map.values():
+        for a, b in zip(indices, indices[1:]):
+            next_links[a] = b
+            prev_links[b] = a
+
+    def u16(values: list[int]) -> bytes:
+        return b"".join(struct.pack("<H", v) for v in values)
+    return u16(offsets), u16(members), u16(prev_links), u16(next_links)
+
+
+def class_blob(eclipses: list[dict], kind: str) -> bytes:
+    """One bitmap per type class, bit i set when eclipse i belongs to the
+    class, so a type-filtered search can jump to the next candidate."""
+    if kind == "solar":
+        classes, type_map = SOLAR_TYPE_CLASSES, SOLAR_ECL_TYPE_MAP
+    else:
+        classes, type_map = LUNAR_TYPE_CLASSES, LUNAR_ECL_TYPE_MAP
+    words = (len(eclipses) + 31) // 32
+    codes = [type_map.get(e["ecl_type"], 0) for e in eclipses]
+    blob  = bytearray()
+    for _, names in classes:
+        members = {type_map[t] for t in names}
+        bits = 0
+        for i, c in enumerate(codes):
+            if c in members:
+                bits |= 1 << i
+        blob += bits.to_bytes(words * 4, "little")
+    return bytes(blob)
+
+
+def dmax_blob(eclipses: list[dict], kind: str) -> tuple[bytes, int]:
+    """Range-max trees over the duration fields: one implicit binary tree
+    (node 1 = root, children 2k / 2k+1) per field, whose leaves are blocks of
+    DURATION_MAX_BLOCK eclipses.  A node holds the largest key below it,
+    where the key of a duration is seconds + 1 and n/a is 0.  Returns the
+    trees and their number of leaves."""
+    if kind == "solar":
+        rows   = [SOLAR_INFO_RECORD.unpack(pack_solar_info(e)) for e in eclipses]
+        fields = (2,)
+    else:
+        rows   = [LUNAR_INFO_RECORD.unpack(pack_lunar_info(e)) for e in eclipses]
+        fields = (0, 1, 2)
+    n      = len(eclipses)
+    blocks = max(1, (n + DURATION_MAX_BLOCK - 1) // DURATION_MAX_BLOCK)
+    leaves = 1
+    while leaves < blocks:
+        leaves *= 2
+    blob = bytearray()
+    for field in fields:
+        keys = [0 if row[field] == 0xFFFF else row[field] + 1 for row in rows]
+        tree = [0] * (2 * leaves)
+        for b in range(blocks):
+            tree[leaves + b] = max(keys[b * DURATION_MAX_BLOCK:(b + 1) * DURATION_MAX_BLOCK],
+                                   default=0)
+        for v in range(leaves - 1, 0, -1):
+            tree[v] = max(tree[2 * v], tree[2 * v + 1])
+        blob += struct.pack(f"<{2 * leaves}H", *tree)
+    return bytes(blob), leaves
+
+
+def geo_blobs(eclipses: list[dict]) -> tuple[bytes, bytes, int]:
+    """Lat/lon grid over the solar greatest-eclipse points: cells of
+    GEO_CELL_DEG10 tenths of a degree, row-major from (-90, -180), as CSR
+    offsets plus the members of each cell in global index (time) order.
+    Returns offsets, members and the size of the fullest cell."""
+    n = len(eclipses)
+    if n > 0xFFFF:
+        raise ValueError(f"{n} eclipses do not fit the uint16 grid members")
+    rows  = 1800 // GEO_CELL_DEG10
+    cols  = 3600 // GEO_CELL_DEG10
+    cells: list[list[int]] = [[] for _ in range(rows * cols)]
+    for i, e in enumerate(eclipses):
+        lat10, lon10 = SOLAR_INFO_RECORD.unpack(pack_solar_info(e))[:2]
+        row = min((lat10 + 900) // GEO_CELL_DEG10, rows - 1)
+        col = ((lon10 + 1800) // GEO_CELL_DEG10) % cols
+        cells[row * cols + col].append(i)
+    offsets = [0]
+    members: list[int] = []
+    for c in cells:
+        members += c
+        offsets.append(len(members))
+    return (struct.pack(f"<{len(offsets)}H", *offsets),
+            struct.pack(f"<{len(members)}H", *members),
+            max(len(c) for c in cells))
+
+
+def _crc32c_table() -> list[int]:
+    table = []
+    for i in range(256):
+        c = i
+        for _ in range(8):
+            c = (c >> 1) ^ 0x82F63B78 if c & 1 else c >> 1
+        table.append(c)
+    return table
+
+
+CRC32C_TABLE = _crc32c_table()
+
+
+def crc32c(data: bytes, crc: int = 0) -> int:
+    """CRC32C of data; pass the previous result as crc to continue it."""
+    crc ^= 0xFFFFFFFF
+    for b in data:
+        crc = CRC32C_TABLE[(crc ^ b) & 0xFF] ^ (crc >> 8)
+    return crc ^ 0xFFFFFFFF
+
+
 # ── Binary DB builder ────────────────────────────────────────────────────────
 
 def build(kind: str, out_dir: str):
@@ -165,42 +490,88 @@ def build(kind: str, out_dir: str):
 
     os.makedirs(out_dir, exist_ok=True)
 
-    pack_info = pack_solar_info if kind == "solar" else pack_lunar_info
-
-    # Build saros index map
-    saros_index_map: dict[int, list[int]] = {}
-    for global_idx, e in enumerate(eclipses):
-        saros_index_map.setdefault(e["_saros_number"], []).append(global_idx)
-
     # eclipse_times.db
     times_path = os.path.join(out_dir, "eclipse_times.db")
     with open(times_path, "wb") as f:
-        for e in eclipses:
-            f.write(ECLIPSE_TIMES_RECORD.pack(e["unix_timestamp"]))
+        f.write(times_blob(eclipses))
     print(f"  eclipse_times.db: {total * ECLIPSE_TIMES_RECORD.size:,} bytes")
 
     # eclipse_info.db
     info_path = os.path.join(out_dir, "eclipse_info.db")
     with open(info_path, "wb") as f:
-        for e in eclipses:
-            f.write(pack_info(e))
+        f.write(info_blob(eclipses, kind))
     print(f"  eclipse_info.db:  {total * 10:,} bytes")
 
-    # saros.db
-    saros_path = os.path.join(out_dir, "saros.db")
-    with open(saros_path, "wb") as f:
-        for sn in range(1, 181):
-            indices = saros_index_map.get(sn, [])
-            count   = len(indices)
-            padded  = indices + [0] * (MAX_ECLIPSES_PER_SAROS - count)
-            f.write(SAROS_ENTRY_RECORD.pack(count, 0, *padded))
-    print(f"  saros.db:         {180 * SAROS_ENTRY_RECORD.size:,} bytes")
+    # the series index and links of saros_all.h, mapped by saros_db_open()
+    series_bytes = 0
+    for name, blob in zip(SERIES_DB_FILES, series_blobs(eclipses, 1, 180)):
+        with open(os.path.join(out_dir, name), "wb") as f:
+            f.write(blob)
+        series_bytes += len(blob)
+    print(f"  series index:     {series_bytes:,} bytes ({', '.join(SERIES_DB_FILES)})")
 
     total_bytes = (total * ECLIPSE_TIMES_RECORD.size +
                    total * 10 +
-                   180   * SAROS_ENTRY_RECORD.size)
+                   series_bytes)
     print(f"  Total DB size:    {total_bytes:,} bytes ({total_bytes/1024:.1f} KB)")
     print("Done.\n")
+    return eclipses
+
+
+# ── Container builder ────────────────────────────────────────────────────────
+
+def build_container(datasets: dict[str, list[dict]], out_path: str):
+    """Write eclipses.sdb from the sorted eclipses of each kind built."""
+    sections = []   # (kind index, section id, param, bytes)
+    kinds    = []   # (count, saros_first, saros_last) per CONTAINER_KINDS
+    for k, kind in enumerate(CONTAINER_KINDS):
+        eclipses = datasets.get(kind, [])
+        if not eclipses:
+            kinds.append((0, 0, 0))
+            continue
+        saros = [e["_saros_number"] for e in eclipses]
+        kinds.append((len(eclipses), min(saros), max(saros)))
+        dmax, leaves = dmax_blob(eclipses, kind)
+        offsets, members, prev, nxt = series_blobs(eclipses, 1, 180)
+        sections += [
+            (k, SECTION_TIMES,          0, times_blob(eclipses)),
+            (k, SECTION_INFO,           0, info_blob(eclipses, kind)),
+            (k, SECTION_SAROS_OFFSETS,  0, offsets),
+            (k, SECTION_SAROS_MEMBERS,  0, members),
+            (k, SECTION_PREV_IN_SERIES, 0, prev),
+            (k, SECTION_NEXT_IN_SERIES, 0, nxt),
+            (k, SECTION_CLASS,          0, class_blob(eclipses, kind)),
+            (k, SECTION_DMAX,           leaves, dmax),
+        ]
+        if kind == "solar":
+            offsets, members, _ = geo_blobs(eclipses)
+            sections += [(k, SECTION_GEO_OFFSETS, GEO_CELL_DEG10, offsets),
+                         (k, SECTION_GEO_MEMBERS, 0, members)]
+
+    def align(pos: int) -> int:
+        return (pos + CONTAINER_ALIGN - 1) // CONTAINER_ALIGN * CONTAINER_ALIGN
+
+    pos    = align(CONTAINER_HEADER.size + len(sections) * CONTAINER_SECTION.size)
+    table  = bytearray()
+    placed = []
+    for k, sid, param, blob in sections:
+        table += CONTAINER_SECTION.pack(k, sid, 0, crc32c(blob), pos, len(blob), param, 0)
+        placed.append((pos, blob))
+        pos = align(pos + len(blob))
+    data = bytearray(pos)
+    for off, blob in placed:
+        data[off:off + len(blob)] = blob
+    per_kind = [v for count, first, last in kinds for v in (count, first, last, 0)]
+    header = CONTAINER_HEADER.pack(CONTAINER_MAGIC, CONTAINER_VERSION, CONTAINER_HEADER.size,
+                                   len(sections), CONTAINER_SECTION.size, len(data),
+                                   0, 0, *per_kind)
+    header = header[:24] + struct.pack("<I", crc32c(header + table)) + header[28:]
+    data[:len(header)] = header
+    data[len(header):len(header) + len(table)] = table
+    with open(out_path, "wb") as f:
+        f.write(data)
+    print(f"  {os.path.basename(out_path)}: {len(sections)} sections, {len(data):,} bytes "
+          f"({len(data)/1024:.1f} KB)\n")
 
 
 # ── PROGMEM header generator ─────────────────────────────────────────────────
@@ -226,6 +597,13 @@ PROGMEM_MACROS = """\
 #  define ECLIPSE_READ_WORD(p)   (*(const uint16_t *)(p))
 #  define ECLIPSE_READ_DWORD(p)  (*(const uint32_t *)(p))
 #  define ECLIPSE_ATTR           /* nothing */
+#endif
+#ifndef ECLIPSE_CONST
+#  ifdef __cplusplus
+#    define ECLIPSE_CONST        constexpr   /* readable by saros.hpp at compile time */
+#  else
+#    define ECLIPSE_CONST        const
+#  endif
 #endif"""
 
 
@@ -259,21 +637,178 @@ def _header_prologue(guard: str, description: str, size_bytes: int,
 """
 
 
-def emit_times_header(eclipses: list[dict], label: str,
+def _write_dataset_defines(f, kind: str, label: str, n: int,
+                           saros_start: int, saros_end: int):
+    """The _COUNT / _SAROS_FIRST / _SAROS_LAST defines every header of a
+    dataset repeats, so any one of them names the slice on its own."""
+    prefix = f"{kind.upper()}_ECLIPSE_{label.upper()}"
+    f.write(f"#define {prefix}_COUNT       {n}u\n")
+    f.write(f"#define {prefix}_SAROS_FIRST {saros_start}u\n")
+    f.write(f"#define {prefix}_SAROS_LAST  {saros_end}u\n")
+
+
+def emit_times_header(eclipses: list[dict], label: str, kind: str,
                       saros_start: int, saros_end: int, out_path: str):
     blob  = b"".join(ECLIPSE_TIMES_RECORD.pack(e["unix_timestamp"]) for e in eclipses)
-    guard = f"ECLIPSE_TIMES_{label.upper()}_H"
+    guard = f"{kind.upper()}_ECLIPSE_TIMES_{label.upper()}_H"
     n     = len(eclipses)
     with open(out_path, "w", encoding="utf-8") as f:
         f.write(_header_prologue(guard, "Sorted int64_t timestamps.",
                                  len(blob), saros_start, saros_end, n,
                                  os.path.basename(out_path)))
-        f.write(f"#define ECLIPSE_{label.upper()}_COUNT       {n}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_FIRST {saros_start}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_LAST  {saros_end}u\n\n")
-        f.write(f"/* eclipse_times_{label}[] — sorted int64_t timestamps, 8 bytes each.\n"
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write(f"/* {kind}_eclipse_times_{label}[] — sorted int64_t timestamps, 8 bytes each.\n"
+                f" * Size: {len(blob):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_times_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(blob))
+        f.write(f"\n}};\n\n#endif /* {guard} */\n")
+    print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
+
+
+def emit_times_packed_header(eclipses: list[dict], label: str, kind: str,
+                             saros_start: int, saros_end: int, out_path: str):
+    """Block-delta timestamps: an int64 base per block of PACKED_TIMES_BLOCK,
+    then the gap to the previous eclipse for every non-first block member.
+
+    Each block stores its gaps in the fewest bytes (1-4) that hold its widest
+    gap, so a few sparse blocks at the ends of a slice do not widen the rest.
+    """
+    times  = [e["unix_timestamp"] for e in eclipses]
+    n      = len(times)
+    blocks = [times[i:i + PACKED_TIMES_BLOCK] for i in range(0, n, PACKED_TIMES_BLOCK)]
+    bases  = b"".join(ECLIPSE_TIMES_RECORD.pack(blk[0]) for blk in blocks)
+    metas, gap_bytes = [], bytearray()
+    widths = [0] * 5
+    for blk in blocks:
+        gaps   = [b - a for a, b in zip(blk, blk[1:])]
+        widest = max(gaps, default=0)
+        if widest >= 1 << 32:
+            raise ValueError(f"{label}: gap of {widest} s does not fit 32 bits")
+        width  = max(1, (widest.bit_length() + 7) // 8)
+        widths[width] += 1
+        metas.append(struct.pack("<I", (width << 24) | len(gap_bytes)))
+        gap_bytes += b"".join(g.to_bytes(width, "little") for g in gaps)
+    if len(gap_bytes) >= 1 << 24:
+        raise ValueError(f"{label}: {len(gap_bytes)} gap bytes overflow the 24-bit block offsets")
+    meta_off = 8 + len(bases)
+    gap_off  = meta_off + 4 * len(blocks)
+    blob  = struct.pack("<II", meta_off, gap_off) + bases + b"".join(metas) + bytes(gap_bytes)
+    mix   = ", ".join(f"{widths[w]}×{w}" for w in range(1, 5) if widths[w])
+    guard = f"{kind.upper()}_ECLIPSE_TIMES_PACKED_{label.upper()}_H"
+    with open(out_path, "w", encoding="utf-8") as f:
+        f.write(_header_prologue(guard, "Block-delta compressed int64_t timestamps.",
+                                 len(blob), saros_start, saros_end, n,
+                                 os.path.basename(out_path)))
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write(f"/* {kind}_eclipse_times_packed_{label}[] — {len(blocks)} blocks of {PACKED_TIMES_BLOCK}.\n"
+                f" * Layout: [0..3] uint32 meta offset ({meta_off}), [4..7] uint32 gap offset ({gap_off}),\n"
+                f" *         [8..] int64 block bases, uint32 block metas (width << 24 | gap start),\n"
+                f" *         then the gaps.  Blocks by gap width in bytes: {mix}.\n"
+                f" * Size: {len(blob):,} bytes ({len(blob) / max(n, 1):.2f} per eclipse) */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_times_packed_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(blob))
+        f.write(f"\n}};\n\n#endif /* {guard} */\n")
+    print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
+
+
+def eytzinger_order(n: int) -> list[int]:
+    """Return order[k] = sorted rank stored at 1-based BFS slot k (slot 0 unused).
+
+    Filling the implicit binary tree in-order with ranks 0..n-1 yields the
+    Eytzinger layout: the children of slot k are slots 2k and 2k+1.
+    """
+    order = [n] * (n + 1)
+    ranks = iter(range(n))
+
+    def fill(k: int):
+        if k <= n:
+            fill(2 * k)
+            order[k] = next(ranks)
+            fill(2 * k + 1)
+
+    fill(1)
+    return order
+
+
+def emit_eytz_header(eclipses: list[dict], label: str, kind: str,
+                     saros_start: int, saros_end: int, out_path: str):
+    n = len(eclipses)
+    if n > 0xFFFE:
+        raise ValueError(f"{n} eclipses do not fit the uint16 Eytzinger rank map")
+    order = eytzinger_order(n)
+    # Slot 0 is padding so that slot 8k starts on a 64-byte boundary.
+    times = b"".join(ECLIPSE_TIMES_RECORD.pack(eclipses[r]["unix_timestamp"] if k else 0)
+                     for k, r in enumerate(order))
+    ranks = b"".join(struct.pack("<H", r) for r in order)
+    guard = f"{kind.upper()}_ECLIPSE_EYTZ_{label.upper()}_H"
+    size  = len(times) + len(ranks)
+    with open(out_path, "w", encoding="utf-8") as f:
+        f.write(_header_prologue(guard, "Eytzinger (BFS-order) timestamps + rank map.",
+                                 size, saros_start, saros_end, n,
+                                 os.path.basename(out_path)))
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write("#if defined(__GNUC__) && !defined(ECLIPSE_USE_PROGMEM)\n"
+                "#  define ECLIPSE_EYTZ_ALIGN  __attribute__((aligned(64)))\n"
+                "#else\n"
+                "#  define ECLIPSE_EYTZ_ALIGN  /* nothing */\n"
+                "#endif\n\n")
+        f.write(f"/* {kind}_eclipse_eytz_{label}[] — int64_t timestamps in Eytzinger order, 8 bytes each.\n"
+                f" * Slot k (1..{n}) has children 2k and 2k+1; slot 0 is padding.\n"
+                f" * Size: {len(times):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_eytz_{label}[{len(times)}u] "
+                f"ECLIPSE_ATTR ECLIPSE_EYTZ_ALIGN = {{\n")
+        f.write(bytes_to_c_array(times))
+        f.write(f"\n}};\n\n")
+        f.write(f"/* {kind}_eclipse_eytz_rank_{label}[] — uint16_t global index of each Eytzinger slot.\n"
+                f" * Slot 0 holds {n} (the \"not found\" index).\n"
+                f" * Size: {len(ranks):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_eytz_rank_{label}[{len(ranks)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(ranks))
+        f.write(f"\n}};\n\n#endif /* {guard} */\n")
+    print(f"  {os.path.basename(out_path):40s}  {size:>8,} bytes  ({size/1024:.1f} KB)")
+
+
+def emit_bucket_header(eclipses: list[dict], label: str, kind: str,
+                       saros_start: int, saros_end: int, out_path: str,
+                       shift: int):
+    """Direct-address time index: bucket b covers [origin + b<<shift, origin + (b+1)<<shift).
+
+    Entry b is the first global index whose timestamp is >= the bucket start,
+    so any timestamp in bucket b has its lower/upper bound in [entry[b], entry[b+1]].
+    """
+    n = len(eclipses)
+    if n > 0xFFFF:
+        raise ValueError(f"{n} eclipses do not fit the uint16 bucket table")
+    times    = [e["unix_timestamp"] for e in eclipses]
+    origin   = times[0]
+    nbuckets = ((times[-1] - origin) >> shift) + 1
+    starts   = []
+    i = 0
+    for b in range(nbuckets + 1):
+        edge = origin + (b << shift)
+        while i < n and times[i] < edge:
+            i += 1
+        starts.append(i)
+    starts[-1] = n
+    blob  = b"".join(struct.pack("<H", v) for v in starts)
+    widest = max(starts[b + 1] - starts[b] for b in range(nbuckets))
+    guard = f"{kind.upper()}_ECLIPSE_BUCKET_{label.upper()}_H"
+    with open(out_path, "w", encoding="utf-8") as f:
+        f.write(_header_prologue(guard, f"Bucketed time index (bucket width 2^{shift} s).",
+                                 len(blob), saros_start, saros_end, n,
+                                 os.path.basename(out_path)))
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write(f"#define {kind.upper()}_ECLIPSE_{label.upper()}_BUCKET_SHIFT  {shift}u\n")
+        f.write(f"#define {kind.upper()}_ECLIPSE_{label.upper()}_BUCKET_COUNT  {nbuckets}u\n")
+        f.write(f"#define {kind.upper()}_ECLIPSE_{label.upper()}_BUCKET_ORIGIN INT64_C({origin})\n\n")
+        f.write(f"/* {kind}_eclipse_bucket_{label}[] — uint16_t first global index of each bucket,\n"
+                f" * {nbuckets} buckets + 1 terminator (= {n}).  Widest bucket: {widest} eclipses.\n"
                 f" * Size: {len(blob):,} bytes */\n")
-        f.write(f"static const uint8_t eclipse_times_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_bucket_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
         f.write(bytes_to_c_array(blob))
         f.write(f"\n}};\n\n#endif /* {guard} */\n")
     print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
@@ -281,17 +816,17 @@ def emit_times_header(eclipses: list[dict], label: str,
 
 def emit_solar_info_header(eclipses: list[dict], label: str,
                            saros_start: int, saros_end: int, out_path: str):
+    kind  = "solar"
     blob  = b"".join(pack_solar_info(e) for e in eclipses)
-    guard = f"ECLIPSE_INFO_{label.upper()}_H"
+    guard = f"{kind.upper()}_ECLIPSE_INFO_{label.upper()}_H"
     n     = len(eclipses)
     with open(out_path, "w", encoding="utf-8") as f:
         f.write(_header_prologue(guard, "Packed solar eclipse_info_t records (10 bytes each).",
                                  len(blob), saros_start, saros_end, n,
                                  os.path.basename(out_path)))
-        f.write(f"#define ECLIPSE_{label.upper()}_COUNT       {n}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_FIRST {saros_start}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_LAST  {saros_end}u\n\n")
-        f.write(f"/* eclipse_info_{label}[] — 10 bytes each (same order as times array).\n"
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write(f"/* {kind}_eclipse_info_{label}[] — 10 bytes each (same order as times array).\n"
                 f" * Layout per record (little-endian):\n"
                 f" *   [0-1] int16   latitude_deg10\n"
                 f" *   [2-3] int16   longitude_deg10\n"
@@ -301,7 +836,7 @@ def emit_solar_info_header(eclipses: list[dict], label: str,
                 f" *   [8]   uint8   ecl_type  (solar_eclipse_type_t enum)\n"
                 f" *   [9]   uint8   sun_alt\n"
                 f" * Size: {len(blob):,} bytes */\n")
-        f.write(f"static const uint8_t eclipse_info_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_info_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
         f.write(bytes_to_c_array(blob))
         f.write(f"\n}};\n\n#endif /* {guard} */\n")
     print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
@@ -309,17 +844,17 @@ def emit_solar_info_header(eclipses: list[dict], label: str,
 
 def emit_lunar_info_header(eclipses: list[dict], label: str,
                            saros_start: int, saros_end: int, out_path: str):
+    kind  = "lunar"
     blob  = b"".join(pack_lunar_info(e) for e in eclipses)
-    guard = f"ECLIPSE_INFO_{label.upper()}_H"
+    guard = f"{kind.upper()}_ECLIPSE_INFO_{label.upper()}_H"
     n     = len(eclipses)
     with open(out_path, "w", encoding="utf-8") as f:
         f.write(_header_prologue(guard, "Packed lunar eclipse_info_t records (10 bytes each).",
                                  len(blob), saros_start, saros_end, n,
                                  os.path.basename(out_path)))
-        f.write(f"#define ECLIPSE_{label.upper()}_COUNT       {n}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_FIRST {saros_start}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_LAST  {saros_end}u\n\n")
-        f.write(f"/* eclipse_info_{label}[] — 10 bytes each (same order as times array).\n"
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write(f"/* {kind}_eclipse_info_{label}[] — 10 bytes each (same order as times array).\n"
                 f" * Layout per record (little-endian):\n"
                 f" *   [0-1] uint16  pen_duration_s   (0xFFFF = n/a)\n"
                 f" *   [2-3] uint16  par_duration_s   (0xFFFF = n/a)\n"
@@ -329,46 +864,213 @@ def emit_lunar_info_header(eclipses: list[dict], label: str,
                 f" *   [8]   uint8   ecl_type  (lunar_eclipse_type_t enum)\n"
                 f" *   [9]   uint8   _pad\n"
                 f" * Size: {len(blob):,} bytes */\n")
-        f.write(f"static const uint8_t eclipse_info_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_info_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
         f.write(bytes_to_c_array(blob))
         f.write(f"\n}};\n\n#endif /* {guard} */\n")
     print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
 
 
-def emit_saros_header(eclipses: list[dict], label: str,
+def emit_info_packed_header(eclipses: list[dict], label: str, kind: str,
+                            saros_start: int, saros_end: int, out_path: str):
+    """Bit-packed eclipse_info records: the same values as eclipse_info_<label>.h
+    with every field cut to the bits it needs (SAROS_PACKED_INFO)."""
+    if kind == "solar":
+        pack, size, fields = (pack_solar_info_packed, SOLAR_INFO_PACKED_SIZE,
+                              SOLAR_INFO_PACKED_FIELDS)
+    else:
+        pack, size, fields = (pack_lunar_info_packed, LUNAR_INFO_PACKED_SIZE,
+                              LUNAR_INFO_PACKED_FIELDS)
+    blob  = b"".join(pack(e) for e in eclipses)
+    guard = f"{kind.upper()}_ECLIPSE_INFO_PACKED_{label.upper()}_H"
+    n     = len(eclipses)
+    with open(out_path, "w", encoding="utf-8") as f:
+        f.write(_header_prologue(guard, f"Bit-packed {kind} eclipse_info_t records ({size} bytes each).",
+                                 len(blob), saros_start, saros_end, n,
+                                 os.path.basename(out_path)))
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write(f"/* {kind}_eclipse_info_packed_{label}[] — {size} bytes each (same order as times array).\n"
+                f" * Little-endian bit fields, least significant first:\n")
+        shift = 0
+        for name, bits, signed in fields:
+            f.write(f" *   [{shift:2d}..{shift + bits - 1:2d}] {'int' if signed else 'uint'}{bits:<3d} {name}\n")
+            shift += bits
+        f.write(f" * An all-ones duration means n/a" +
+                (f"; durations count {LUNAR_DURATION_UNIT_S} s units.\n" if kind == "lunar"
+                 else " (decoded as 0xFFFF).\n"))
+        f.write(f" * Size: {len(blob):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_info_packed_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(blob))
+        f.write(f"\n}};\n\n#endif /* {guard} */\n")
+    print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
+
+
+def emit_info_columns_header(eclipses: list[dict], label: str, kind: str,
+                             saros_start: int, saros_end: int, out_path: str):
+    """Column-split eclipse_info records: one array per field, back to back,
+    so a scan over one field touches nothing else (SAROS_INFO_COLUMNS)."""
+    if kind == "solar":
+        rows = [SOLAR_INFO_RECORD.unpack(pack_solar_info(e)) for e in eclipses]
+        # record order: lat, lon, dur, saros_number, saros_pos, ecl_type, sun_alt
+        order, columns = (0, 1, 2, 5, 3, 4, 6), SOLAR_INFO_COLUMNS
+    else:
+        rows = [LUNAR_INFO_RECORD.unpack(pack_lunar_info(e)) for e in eclipses]
+        # record order: pen, par, total, saros_number, saros_pos, ecl_type, _pad
+        order, columns = (0, 1, 2, 5, 3, 4), LUNAR_INFO_COLUMNS
+    n     = len(eclipses)
+    blob  = bytearray()
+    layout = []
+    for (name, fmt), field in zip(columns, order):
+        layout.append((len(blob), name, fmt))
+        blob += struct.pack(f"<{n}{fmt}", *(row[field] for row in rows))
+    guard = f"{kind.upper()}_ECLIPSE_INFO_COLUMNS_{label.upper()}_H"
+    with open(out_path, "w", encoding="utf-8") as f:
+        f.write(_header_prologue(guard, f"Column-split {kind} eclipse_info_t records.",
+                                 len(blob), saros_start, saros_end, n,
+                                 os.path.basename(out_path)))
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write(f"/* {kind}_eclipse_info_columns_{label}[] — {len(columns)} columns of {n} values\n"
+                f" * (same order as times array), little-endian:\n")
+        for off, name, fmt in layout:
+            ctype = {"h": "int16 ", "H": "uint16", "B": "uint8 "}[fmt]
+            f.write(f" *   [{off:>7}] {ctype}  {name}[]\n")
+        f.write(f" * Size: {len(blob):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_info_columns_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(bytes(blob)))
+        f.write(f"\n}};\n\n#endif /* {guard} */\n")
+    print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
+
+
+def emit_class_header(eclipses: list[dict], label: str, kind: str,
                       saros_start: int, saros_end: int, out_path: str):
-    saros_local_map: dict[int, list[int]] = {}
-    for local_idx, e in enumerate(eclipses):
-        saros_local_map.setdefault(e["_saros_number"], []).append(local_idx)
+    """Per-class type bitmaps (class_blob) as a header."""
+    classes = SOLAR_TYPE_CLASSES if kind == "solar" else LUNAR_TYPE_CLASSES
+    n     = len(eclipses)
+    words = (n + 31) // 32
+    blob  = class_blob(eclipses, kind)
+    guard = f"{kind.upper()}_ECLIPSE_CLASS_{label.upper()}_H"
+    with open(out_path, "w", encoding="utf-8") as f:
+        f.write(_header_prologue(guard, f"Per-class {kind} eclipse type bitmaps.",
+                                 len(blob), saros_start, saros_end, n,
+                                 os.path.basename(out_path)))
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write("\n")
+        f.write(f"/* {kind}_eclipse_class_{label}[] — {len(classes)} bitmaps of {words} uint32_t words;\n"
+                f" * bit i of bitmap c is set when eclipse i is of class c.  Classes:\n")
+        for c, (name, names) in enumerate(classes):
+            f.write(f" *   [{c}] {name:<10s} {' '.join(names)}\n")
+        f.write(f" * Size: {len(blob):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_class_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(bytes(blob)))
+        f.write(f"\n}};\n\n#endif /* {guard} */\n")
+    print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
 
-    blob = b""
-    for sn in range(saros_start, saros_end + 1):
-        indices = saros_local_map.get(sn, [])
-        count   = len(indices)
-        padded  = indices + [0] * (MAX_ECLIPSES_PER_SAROS - count)
-        blob   += SAROS_ENTRY_RECORD.pack(count, 0, *padded)
 
-    num_saros = saros_end - saros_start + 1
-    guard     = f"SAROS_{label.upper()}_H"
-    n         = len(eclipses)
+def emit_dmax_header(eclipses: list[dict], label: str, kind: str,
+                     saros_start: int, saros_end: int, out_path: str):
+    """Duration range-max trees (dmax_blob) as a header."""
+    if kind == "solar":
+        fields = ("central_duration",)
+    else:
+        fields = ("pen_duration", "par_duration", "total_duration")
+    n = len(eclipses)
+    blob, leaves = dmax_blob(eclipses, kind)
+    guard = f"{kind.upper()}_ECLIPSE_DMAX_{label.upper()}_H"
     with open(out_path, "w", encoding="utf-8") as f:
-        f.write(_header_prologue(guard, "Saros series index records (174 bytes each).",
+        f.write(_header_prologue(guard, f"Range-max trees over the {kind} eclipse durations.",
                                  len(blob), saros_start, saros_end, n,
                                  os.path.basename(out_path)))
-        f.write(f"#define ECLIPSE_{label.upper()}_COUNT       {n}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_FIRST {saros_start}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_LAST  {saros_end}u\n")
-        f.write(f"#define ECLIPSE_{label.upper()}_SAROS_COUNT {num_saros}u\n\n")
-        f.write(f"/* saros_{label}[] — 174-byte records, indexed by (saros_number - {saros_start}).\n"
-                f" * Layout: [0] uint8 count, [1] uint8 _pad, [2..173] uint16 indices[86]\n"
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write(f"#define {kind.upper()}_ECLIPSE_{label.upper()}_DMAX_LEAVES {leaves}u\n\n")
+        f.write(f"/* {kind}_eclipse_dmax_{label}[] — {len(fields)} trees of {2 * leaves} uint16_t nodes:\n"
+                f" *   {', '.join(fields)}.\n"
+                f" * Leaf {leaves} + b covers eclipses [b * {DURATION_MAX_BLOCK}, (b + 1) * {DURATION_MAX_BLOCK}); "
+                f"node 0 is unused.\n"
+                f" * Node value = max(duration_s + 1) below it, 0 when all are n/a.\n"
                 f" * Size: {len(blob):,} bytes */\n")
-        f.write(f"static const uint8_t saros_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
-        f.write(bytes_to_c_array(blob))
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_dmax_{label}[{len(blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(bytes(blob)))
         f.write(f"\n}};\n\n#endif /* {guard} */\n")
     print(f"  {os.path.basename(out_path):40s}  {len(blob):>8,} bytes  ({len(blob)/1024:.1f} KB)")
 
 
-def build_headers(kind: str, out_dir: str):
+def emit_geo_header(eclipses: list[dict], label: str,
+                    saros_start: int, saros_end: int, out_path: str):
+    """Lat/lon grid of the greatest-eclipse points (geo_blobs) as a header."""
+    kind = "solar"
+    n = len(eclipses)
+    rows  = 1800 // GEO_CELL_DEG10
+    cols  = 3600 // GEO_CELL_DEG10
+    offsets_blob, members_blob, fullest = geo_blobs(eclipses)
+    guard = f"{kind.upper()}_ECLIPSE_GEO_{label.upper()}_H"
+    size  = len(offsets_blob) + len(members_blob)
+    with open(out_path, "w", encoding="utf-8") as f:
+        f.write(_header_prologue(guard, "Lat/lon grid of the greatest-eclipse points.",
+                                 size, saros_start, saros_end, n,
+                                 os.path.basename(out_path)))
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write(f"#define {kind.upper()}_ECLIPSE_{label.upper()}_GEO_CELL    {GEO_CELL_DEG10}u\n\n")
+        f.write(f"/* {kind}_eclipse_geo_offsets_{label}[] — uint16_t, {rows} x {cols} cells + 1 terminator.\n"
+                f" * Cell row * {cols} + col covers latitude_deg10 in\n"
+                f" * [-900 + row * {GEO_CELL_DEG10}, -900 + (row + 1) * {GEO_CELL_DEG10}) "
+                f"(the last row includes +900) and\n"
+                f" * longitude_deg10 in [-1800 + col * {GEO_CELL_DEG10}, -1800 + (col + 1) * "
+                f"{GEO_CELL_DEG10}) (+1800 wraps to col 0).\n"
+                f" * Size: {len(offsets_blob):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_geo_offsets_{label}[{len(offsets_blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(offsets_blob))
+        f.write(f"\n}};\n\n")
+        f.write(f"/* {kind}_eclipse_geo_members_{label}[] — uint16_t global indices grouped by cell,\n"
+                f" * in time order within each cell.  Fullest cell: {fullest} eclipses.\n"
+                f" * Size: {len(members_blob):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_eclipse_geo_members_{label}[{len(members_blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(members_blob))
+        f.write(f"\n}};\n\n#endif /* {guard} */\n")
+    print(f"  {os.path.basename(out_path):40s}  {size:>8,} bytes  ({size/1024:.1f} KB)")
+
+
+def emit_saros_header(eclipses: list[dict], label: str, kind: str,
+                      saros_start: int, saros_end: int, out_path: str):
+    n = len(eclipses)
+    offsets_blob, members_blob, prev_blob, next_blob = \
+        series_blobs(eclipses, saros_start, saros_end)
+
+    num_saros = saros_end - saros_start + 1
+    guard     = f"{kind.upper()}_SAROS_{label.upper()}_H"
+    size      = (len(offsets_blob) + len(members_blob) +
+                 len(prev_blob) + len(next_blob))
+    with open(out_path, "w", encoding="utf-8") as f:
+        f.write(_header_prologue(guard, "Saros series index (CSR) + per-eclipse series links.",
+                                 size, saros_start, saros_end, n,
+                                 os.path.basename(out_path)))
+        _write_dataset_defines(f, kind, label, n, saros_start, saros_end)
+        f.write(f"#define {kind.upper()}_ECLIPSE_{label.upper()}_SAROS_COUNT {num_saros}u\n\n")
+        f.write(f"/* {kind}_saros_offsets_{label}[] — uint16_t, {num_saros} series + 1 terminator.\n"
+                f" * Series s occupies {kind}_saros_members_{label}[offsets[s - {saros_start}] ..\n"
+                f" * offsets[s - {saros_start} + 1]).\n"
+                f" * Size: {len(offsets_blob):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_saros_offsets_{label}[{len(offsets_blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(offsets_blob))
+        f.write(f"\n}};\n\n")
+        f.write(f"/* {kind}_saros_members_{label}[] — uint16_t global indices grouped by series,\n"
+                f" * in time order within each series.\n"
+                f" * Size: {len(members_blob):,} bytes */\n")
+        f.write(f"static ECLIPSE_CONST uint8_t {kind}_saros_members_{label}[{len(members_blob)}u] ECLIPSE_ATTR = {{\n")
+        f.write(bytes_to_c_array(members_blob))
+        f.write(f"\n}};\n\n")
+        for name, links in (("prev", prev_blob), ("next", next_blob)):
+            f.write(f"/* {kind}_{name}_in_series_{label}[] — uint16_t global index of the {name} eclipse in\n"
+                    f" * the same Saros series (0xFFFF = none), parallel to {kind}_eclipse_times_{label}[].\n"
+                    f" * Size: {len(links):,} bytes */\n")
+            f.write(f"static ECLIPSE_CONST uint8_t {kind}_{name}_in_series_{label}[{len(links)}u] ECLIPSE_ATTR = {{\n")
+            f.write(bytes_to_c_array(links))
+            f.write(f"\n}};\n\n")
+        f.write(f"#endif /* {guard} */\n")
+    print(f"  {os.path.basename(out_path):40s}  {size:>8,} bytes  ({size/1024:.1f} KB)")
+
+
+def build_headers(kind: str, out_dir: str, bucket_shift: int = DEFAULT_BUCKET_SHIFT):
     print(f"Loading {kind} eclipse data for headers...")
     all_eclipses = load_eclipses(kind)
     if not all_eclipses:
@@ -389,12 +1091,30 @@ def build_headers(kind: str, out_dir: str):
 
     for label, s_start, s_end, eclipses in slices:
         print(f"  — {label} (saros {s_start}–{s_end}, {len(eclipses)} eclipses)")
-        emit_times_header(eclipses, label, s_start, s_end,
+        emit_times_header(eclipses, label, kind, s_start, s_end,
                           os.path.join(out_dir, f"eclipse_times_{label}.h"))
         emit_info(eclipses, label, s_start, s_end,
                   os.path.join(out_dir, f"eclipse_info_{label}.h"))
-        emit_saros_header(eclipses, label, s_start, s_end,
+        emit_saros_header(eclipses, label, kind, s_start, s_end,
                           os.path.join(out_dir, f"saros_{label}.h"))
+        emit_info_packed_header(eclipses, label, kind, s_start, s_end,
+                                os.path.join(out_dir, f"eclipse_info_packed_{label}.h"))
+        emit_info_columns_header(eclipses, label, kind, s_start, s_end,
+                                 os.path.join(out_dir, f"eclipse_info_columns_{label}.h"))
+        emit_class_header(eclipses, label, kind, s_start, s_end,
+                          os.path.join(out_dir, f"eclipse_class_{label}.h"))
+        emit_dmax_header(eclipses, label, kind, s_start, s_end,
+                         os.path.join(out_dir, f"eclipse_dmax_{label}.h"))
+        if kind == "solar":
+            emit_geo_header(eclipses, label, s_start, s_end,
+                            os.path.join(out_dir, f"eclipse_geo_{label}.h"))
+        emit_times_packed_header(eclipses, label, kind, s_start, s_end,
+                                 os.path.join(out_dir, f"eclipse_times_packed_{label}.h"))
+        emit_eytz_header(eclipses, label, kind, s_start, s_end,
+                         os.path.join(out_dir, f"eclipse_eytz_{label}.h"))
+        emit_bucket_header(eclipses, label, kind, s_start, s_end,
+                           os.path.join(out_dir, f"eclipse_bucket_{label}.h"),
+                           bucket_shift)
         print()
 
     print("Done.\n")
@@ -403,17 +1123,33 @@ def build_headers(kind: str, out_dir: str):
 # ── Entry point ───────────────────────────────────────────────────────────────
 
 if __name__ == "__main__":
-    kinds = sys.argv[1:] if len(sys.argv) > 1 else ["solar", "lunar"]
-    valid = {"solar", "lunar"}
+    parser = argparse.ArgumentParser(
+        description="Build binary .db files and C headers from the JSONL data.")
+    parser.add_argument("kinds", nargs="*", metavar="solar|lunar",
+                        help="Datasets to build (default: both)")
+    parser.add_argument("--bucket-shift", type=int, default=DEFAULT_BUCKET_SHIFT,
+                        metavar="K",
+                        help=f"Bucket width of eclipse_bucket_*.h as 2^K seconds "
+                             f"(default: {DEFAULT_BUCKET_SHIFT})")
+    args = parser.parse_args()
+    if not 16 <= args.bucket_shift <= 40:
+        parser.error("--bucket-shift must be between 16 and 40")
+    kinds = args.kinds or ["solar", "lunar"]
     for k in kinds:
-        if k not in valid:
-            print(f"Usage: {sys.argv[0]} [solar] [lunar]", file=sys.stderr)
-            sys.exit(1)
+        if k not in {"solar", "lunar"}:
+            parser.error(f"unknown dataset {k!r} (expected solar or lunar)")
 
+    datasets = {}
     for kind in kinds:
         out_dir = os.path.join(SCRIPT_DIR, kind)
         print(f"{'='*60}")
         print(f"  Building {kind.upper()} databases -> db/{kind}/")
         print(f"{'='*60}")
-        build(kind, out_dir)
-        build_headers(kind, out_dir)
+        eclipses = build(kind, out_dir)
+        if eclipses:
+            datasets[kind] = eclipses
+        build_headers(kind, out_dir, args.bucket_shift)
+
+    if datasets:
+        print(f"Writing db/{CONTAINER_NAME} ({', '.join(datasets)})...")
+        build_container(datasets, os.path.join(SCRIPT_DIR, CONTAINER_NAME))
@@ -0,0 +1,86 @@
+/*
+ * ctx_impl.c — Context-handle translation unit: the saros_find_*(ctx, ...)
+ * calls and the four generated datasets as saros_ctx_t, so one binary can
+ * answer from the modern and the full catalog of both kinds side by side.
+ *
+ * Links with any of the other impl files or on its own; by default the
+ * modern and all arrays here are separate copies from theirs.  Define
+ * SAROS_SHARE_CTX (and SAROS_USE_ALL if they do) in every unit to reuse
+ * the slice the SOLAR / LUNAR units already link: they export its two
+ * handles and this file defines only the other slice.  Not compatible with
+ * SAROS_PACKED_TIMES, SAROS_PACKED_INFO or SAROS_INFO_COLUMNS: the datasets
+ * are exported in the plain layout.  Optionally define ECLIPSE_USE_PROGMEM
+ * on AVR/ESP32.
+ */
+
+#define SAROS_IMPL_CTX
+
+/* Under SAROS_SHARE_CTX the compiled-in units export their own slice */
+#if !defined(SAROS_SHARE_CTX) || defined(SAROS_USE_ALL)
+#  define CTX_MODERN
+#endif
+#if !defined(SAROS_SHARE_CTX) || !defined(SAROS_USE_ALL)
+#  define CTX_ALL
+#endif
+
+#ifdef CTX_MODERN
+#include "solar/eclipse_times_modern.h"
+#include "solar/eclipse_info_modern.h"
+#include "solar/saros_modern.h"
+#include "solar/eclipse_class_modern.h"
+#include "solar/eclipse_dmax_modern.h"
+#include "solar/eclipse_geo_modern.h"
+#include "lunar/eclipse_times_modern.h"
+#include "lunar/eclipse_info_modern.h"
+#include "lunar/saros_modern.h"
+#include "lunar/eclipse_class_modern.h"
+#include "lunar/eclipse_dmax_modern.h"
+#endif
+#ifdef CTX_ALL
+#include "solar/eclipse_times_all.h"
+#include "solar/eclipse_info_all.h"
+#include "solar/saros_all.h"
+#include "solar/eclipse_class_all.h"
+#include "solar/eclipse_dmax_all.h"
+#include "solar/eclipse_geo_all.h"
+#include "lunar/eclipse_times_all.h"
+#include "lunar/eclipse_info_all.h"
+#include "lunar/saros_all.h"
+#include "lunar/eclipse_class_all.h"
+#include "lunar/eclipse_dmax_all.h"
+#endif
+#include "saros.h"
+
+#ifdef CTX_MODERN
+const saros_ctx_t saros_ctx_solar_modern = {
+    SAROS_CTX(solar, SOLAR, modern, MODERN),
+    solar_eclipse_class_modern,
+    solar_eclipse_dmax_modern, SOLAR_ECLIPSE_MODERN_DMAX_LEAVES,
+    solar_eclipse_geo_offsets_modern, solar_eclipse_geo_members_modern,
+    SOLAR_ECLIPSE_MODERN_GEO_CELL,
+};
+
+const saros_ctx_t saros_ctx_lunar_modern = {
+    SAROS_CTX(lunar, LUNAR, modern, MODERN),
+    lunar_eclipse_class_modern,
+    lunar_eclipse_dmax_modern, LUNAR_ECLIPSE_MODERN_DMAX_LEAVES,
+    0, 0, 0u,
+};
+#endif
+
+#ifdef CTX_ALL
+const saros_ctx_t saros_ctx_solar_all = {
+    SAROS_CTX(solar, SOLAR, all, ALL),
+    solar_eclipse_class_all,
+    solar_eclipse_dmax_all, SOLAR_ECLIPSE_ALL_DMAX_LEAVES,
+    solar_eclipse_geo_offsets_all, solar_eclipse_geo_members_all,
+    SOLAR_ECLIPSE_ALL_GEO_CELL,
+};
+
+const saros_ctx_t saros_ctx_lunar_all = {
+    SAROS_CTX(lunar, LUNAR, all, ALL),
+    lunar_eclipse_class_all,
+    lunar_eclipse_dmax_all, LUNAR_ECLIPSE_ALL_DMAX_LEAVES,
+    0, 0, 0u,
+};
+#endif
@@ -0,0 +1,14 @@
+/*
+ * db_impl.c — Runtime dataset translation unit: saros_db_open() and the
+ * saros_db_*() lookups over the .db files written by build_db.py, and the
+ * saros_db_live_*() hot swap.
+ *
+ * Needs no generated headers, so it links with any of the other impl files
+ * or on its own.  POSIX only (open/mmap, pthreads; build with -pthread).  Not compatible with
+ * SAROS_PACKED_TIMES, SAROS_PACKED_INFO, SAROS_INFO_COLUMNS or
+ * ECLIPSE_USE_PROGMEM, which change how the shared readers see the data.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#define SAROS_IMPL_DB
+#include "saros.h"
@@ -3,24 +3,20 @@
  *
  * ── Usage ─────────────────────────────────────────────────────────────────
  *
- * The solar and lunar data headers share identical array names (e.g.
- * eclipse_times_modern[]) so they cannot both be included in the same
- * translation unit.  Compile two separate translation units:
+ * Every symbol in the data headers carries its kind (solar_eclipse_times_modern[],
+ * LUNAR_ECLIPSE_MODERN_COUNT, ...), so both kinds can be implemented in one
+ * translation unit:
  *
- *   solar_impl.c / solar_impl.cpp
+ *   saros_impl.c / saros_impl.cpp
  *   ─────────────────────────────
  *   #define SAROS_IMPL_SOLAR          // activates solar implementation
+ *   #define SAROS_IMPL_LUNAR          // activates lunar implementation
  *   // #define SAROS_USE_ALL          // uncomment to use full Saros 1-180 dataset
  *                                     // default is "modern" (Saros 110-173)
  *   // #define ECLIPSE_USE_PROGMEM    // uncomment on AVR/ESP32 to store in flash
  *   #include "solar/eclipse_times_modern.h"
  *   #include "solar/eclipse_info_modern.h"
  *   #include "solar/saros_modern.h"
- *   #include "saros.h"
- *
- *   lunar_impl.c / lunar_impl.cpp
- *   ─────────────────────────────
- *   #define SAROS_IMPL_LUNAR
  *   #include "lunar/eclipse_times_modern.h"
  *   #include "lunar/eclipse_info_modern.h"
  *   #include "lunar/saros_modern.h"
@@ -29,7 +25,28 @@
  *   main.c / sketch.ino
  *   ───────────────────
  *   #include "saros.h"                // declarations only — no SAROS_IMPL_*
- *   // call find_next_solar_eclipse(), find_next_lunar_eclipse(), etc.
+ *   // call find_next_solar_eclipse(), find_next_eclipse_any(), etc.
+ *
+ * Drop either SAROS_IMPL_* define and its headers to build one kind only.
+ * The kinds can also live in two units (solar_impl.c and lunar_impl.c, one
+ * SAROS_IMPL_* each); the calls that merge both, find_*_eclipse_any() and
+ * eclipse_timeline_*(), then come from a third unit that defines
+ * SAROS_IMPL_TIMELINE and includes only saros.h (timeline_impl.c).
+ *
+ * To read the .db files at run time instead of compiling the data in,
+ * link a unit that defines SAROS_IMPL_DB and includes only saros.h
+ * (db_impl.c) and call saros_db_open(); POSIX hosts only.  A
+ * saros_db_live_t lets a long-running process swap in a new build while
+ * other threads keep querying.
+ *
+ * To serve several datasets from one program, link ctx_impl.c (defines
+ * SAROS_IMPL_CTX and includes every data header) and pass one of its
+ * saros_ctx_t handles to saros_find_next() and friends.  With
+ * SAROS_SHARE_CTX defined everywhere, the compiled-in slice's handles come
+ * from the compiled-in units instead of a second copy in ctx_impl.c.
+ *
+ * C++20 code can include saros.hpp after the data headers instead, for
+ * constexpr lookups that fold constant queries at compile time.
  *
  * ── Data slices ───────────────────────────────────────────────────────────
  *   "modern"  Saros 110–173  (default, ~4500 eclipses, lower flash usage)
@@ -38,6 +55,62 @@
  *   To use "all" define SAROS_USE_ALL before including the data headers and
  *   this file, and change the included header names accordingly.
  *
+ * ── Search layout ─────────────────────────────────────────────────────────
+ *   By default find_next / find_past binary-search the sorted
+ *   eclipse_times_*[] array.  Define SAROS_LAYOUT_EYTZINGER (and include
+ *   the matching eclipse_eytz_*.h header) to search a BFS-ordered copy
+ *   instead: the probe sequence walks down an implicit tree whose top
+ *   levels stay in cache, and the next levels are prefetched on hosted
+ *   targets.  Worth it for large random-timestamp workloads on the "all"
+ *   slice; costs 10 extra bytes of flash per eclipse.
+ *
+ *   Alternatively define SAROS_USE_BUCKET_INDEX (and include the matching
+ *   eclipse_bucket_*.h header) to put a direct-address time index in front
+ *   of the binary search: one table load narrows the search to the handful
+ *   of eclipses in the timestamp's bucket.  The bucket width is chosen when
+ *   the header is generated (build_db.py --bucket-shift).
+ *
+ *   On x86-64 and AArch64 hosts the binary search (plain or bucketed) stops
+ *   once eight candidates remain and finishes with a single vector compare
+ *   plus popcount — AVX2 or SSE4.2 picked at runtime, NEON on AArch64.
+ *   PROGMEM builds always use the scalar search; define SAROS_NO_SIMD to
+ *   force it on hosts too.
+ *
+ *   Define SAROS_PACKED_TIMES (and include eclipse_times_packed_*.h in place
+ *   of eclipse_times_*.h) to keep the timestamps block-delta compressed:
+ *   an int64 base per block of 16 plus a 1–4 byte gap per eclipse (the
+ *   width is picked per block), about 3.6 bytes per eclipse instead of 8.
+ *   Searches run on the compressed form: a binary search over the block
+ *   bases, then a short scan of one block.  Cannot be combined with
+ *   SAROS_LAYOUT_EYTZINGER or SAROS_USE_BUCKET_INDEX.
+ *
+ *   Define SAROS_PACKED_INFO (and include eclipse_info_packed_*.h in place
+ *   of eclipse_info_*.h) to store the per-eclipse info as bit fields:
+ *   8 bytes per solar and 7 per lunar eclipse instead of 10.  The decoded
+ *   records are identical.  Combines with any search layout.
+ *
+ *   Alternatively define SAROS_INFO_COLUMNS (and include
+ *   eclipse_info_columns_*.h in place of eclipse_info_*.h) to store each
+ *   info field as its own column.  Reading one field, such as the type
+ *   tested by *_range_next_of(), then touches one byte per eclipse instead
+ *   of a whole record; decoding a full record costs a few more cache lines.
+ *
+ *   Define SAROS_USE_CLASS_INDEX (and include the matching eclipse_class_*.h
+ *   header) to give the type-filtered functions one bitmap per eclipse
+ *   class (e.g. total, partial): they jump straight to the next eclipse of
+ *   a wanted class instead of testing each type.  Costs one bit per
+ *   eclipse per class.
+ *
+ *   Define SAROS_USE_DURATION_INDEX (and include the matching
+ *   eclipse_dmax_*.h header) to answer the *_min_duration() queries from
+ *   range-max trees over blocks of 16 eclipses: about a quarter byte per
+ *   eclipse per duration field.
+ *
+ *   Define SAROS_USE_GEO_INDEX (and include the matching solar
+ *   eclipse_geo_*.h header) to build find_solar_eclipses_near(), which then
+ *   reads only the 10 x 10 degree grid cells around the query point.  Costs
+ *   2 bytes per eclipse plus 1.3 KB, and the program links with -lm.
+ *
  * ── PROGMEM (AVR / ESP32) ─────────────────────────────────────────────────
  *   Define ECLIPSE_USE_PROGMEM before including the data headers.
  *   The data headers define the ECLIPSE_READ_* macros accordingly.
@@ -46,6 +119,7 @@
 #ifndef SAROS_H
 #define SAROS_H
 
+#include <stddef.h>   /* size_t */
 #include <stdint.h>
 #include <string.h>   /* memset, memcpy */
 
@@ -57,9 +131,13 @@
 #endif
 
 /* ── Constants ──────────────────────────────────────────────────────────── */
-#define SAROS_MAX_ECLIPSES  96u
-#define SAROS_RECORD_SIZE  194u   /* uint8 count + uint8 pad + uint16[96] */
 #define ECLIPSE_INFO_SIZE   10u
+#define SAROS_NO_ECLIPSE    UINT32_MAX   /* "no eclipse" from the *_index() API */
+#define SAROS_EARTH_RADIUS_KM 6371.0     /* mean radius, for find_solar_eclipses_near() */
+
+/* Bit of one eclipse type in a type_mask, e.g.
+ * SAROS_TYPE_BIT(SOLAR_ECL_T) | SAROS_TYPE_BIT(SOLAR_ECL_Tplus) */
+#define SAROS_TYPE_BIT(t)   ((uint32_t)1u << (t))
 
 /* ── Types ──────────────────────────────────────────────────────────────── */
 
@@ -119,6 +197,23 @@ typedef enum {
     LUNAR_ECL_TYPE_COUNT = 13
 } lunar_eclipse_type_t;
 
+/** Type masks of the eclipse classes, for the *_of() functions and the
+ *  class bitmaps (match SOLAR/LUNAR_TYPE_CLASSES in build_db.py). */
+#define SOLAR_TYPES_ANNULAR    0x0000003Fu   /* A A+ A- Am An As */
+#define SOLAR_TYPES_HYBRID     0x000003C0u   /* H H2 H3 Hm */
+#define SOLAR_TYPES_PARTIAL    0x00001C00u   /* P Pb Pe */
+#define SOLAR_TYPES_TOTAL      0x0007E000u   /* T T+ T- Tm Tn Ts */
+#define LUNAR_TYPES_PENUMBRAL  0x0000000Fu   /* N Nb Ne Nx */
+#define LUNAR_TYPES_PARTIAL    0x00000070u   /* P Pb Pe */
+#define LUNAR_TYPES_TOTAL      0x00001F80u   /* T T+ T- Tm Tn Ts */
+
+/** Phase whose duration find_*_lunar_eclipse_min_duration() tests. */
+typedef enum {
+    LUNAR_PHASE_PENUMBRAL = 0,   /**< pen_duration */
+    LUNAR_PHASE_PARTIAL   = 1,   /**< par_duration */
+    LUNAR_PHASE_TOTAL     = 2    /**< total_duration */
+} lunar_phase_t;
+
 /** Decoded solar eclipse record (expanded from the 10-byte packed form). */
 typedef struct {
     int16_t  latitude_deg10;   /**< latitude  × 10, e.g. 633 = 63.3°N */
@@ -180,6 +275,123 @@ typedef struct {
     uint8_t         saros_number;
 } saros_window_t;
 
+/**
+ * eclipse_range_t — cursor over the eclipses in [t0, t1), returned by
+ * solar/lunar_eclipse_range().  It only holds indices; time and info are read
+ * from the dataset when the accessors ask for them.
+ *
+ * index : global index of the current eclipse (valid after *_range_next() == 1)
+ */
+typedef struct {
+    uint32_t next;             /**< global index the next step moves to */
+    uint32_t end;              /**< one past the last eclipse in the range */
+    uint32_t index;            /**< current eclipse */
+    /* *_range_next_of() state: matches of of_mask among eclipses 32*of_word.. */
+    uint32_t of_mask;          /**< type mask of_set and of_bits are for */
+    uint32_t of_set;           /**< class bitmaps covering of_mask, and exact flag */
+    uint32_t of_word;          /**< 32-eclipse word of_bits describes */
+    uint32_t of_bits;          /**< bit i: eclipse 32*of_word + i matches */
+} eclipse_range_t;
+
+/**
+ * solar_near_fn — callback of find_solar_eclipses_near().
+ *
+ * idx         : global index of the eclipse (read it with saros_solar_*(idx))
+ * distance_km : great-circle distance from the query point to greatest eclipse
+ * user        : the pointer passed to find_solar_eclipses_near()
+ * Return 0 to continue, nonzero to stop the search.
+ */
+typedef int (*solar_near_fn)(uint32_t idx, double distance_km, void *user);
+
+/** Which dataset an eclipse of the merged solar + lunar calls comes from. */
+typedef enum {
+    ECLIPSE_KIND_SOLAR = 0,
+    ECLIPSE_KIND_LUNAR = 1
+} eclipse_kind_t;
+
+/**
+ * eclipse_any_result_t — returned by find_next/past_eclipse_any().
+ *
+ * result : as find_next/past_solar/lunar_eclipse() return it; read
+ *          result.eclipse.info.solar or .lunar according to kind
+ * kind   : dataset of result
+ */
+typedef struct {
+    eclipse_result_t result;
+    eclipse_kind_t   kind;
+} eclipse_any_result_t;
+
+/**
+ * eclipse_timeline_t — cursor over the solar and lunar eclipses in [t0, t1)
+ * in one time order, returned by eclipse_timeline().  Each kind keeps its
+ * own range cursor one eclipse ahead, with that eclipse's time cached.
+ *
+ * kind, index, time : the current eclipse (valid after eclipse_timeline_next() == 1);
+ *                     index is the global index within its kind
+ */
+typedef struct {
+    eclipse_range_t solar;     /**< solar cursor, on the next solar eclipse */
+    eclipse_range_t lunar;     /**< lunar cursor, on the next lunar eclipse */
+    int64_t  solar_time;       /**< time of the solar cursor's eclipse */
+    int64_t  lunar_time;       /**< time of the lunar cursor's eclipse */
+    uint8_t  solar_live;       /**< 1 while the solar cursor holds an eclipse */
+    uint8_t  lunar_live;       /**< 1 while the lunar cursor holds an eclipse */
+    eclipse_kind_t kind;       /**< current eclipse */
+    uint32_t index;
+    int64_t  time;
+} eclipse_timeline_t;
+
+/**
+ * saros_ctx_t — one dataset (a kind and a slice) as pointers to its
+ * generated arrays, for the saros_find_*(ctx, ...) calls.  Holds no state,
+ * so one binary can query any number of them from any thread.  ctx_impl.c
+ * exports the four that build_db.py generates; SAROS_CTX() fills the
+ * required fields from the headers in your own unit.  The optional indexes
+ * are NULL (and their parameters 0) when absent.
+ */
+typedef struct {
+    eclipse_kind_t kind;
+    uint32_t       count;                     /**< eclipses */
+    uint8_t        saros_first, saros_last;   /**< series covered */
+    const uint8_t *times;                     /**< eclipse_times_*[] */
+    const uint8_t *info;                      /**< eclipse_info_*[] */
+    const uint8_t *saros_offsets;             /**< saros_*.h: CSR series index */
+    const uint8_t *saros_members;
+    const uint8_t *prev_in_series;            /**< saros_*.h: per-eclipse links */
+    const uint8_t *next_in_series;
+    const uint8_t *class_bitmaps;             /**< eclipse_class_*[] (optional) */
+    const uint8_t *dmax;                      /**< eclipse_dmax_*[] (optional) */
+    uint32_t       dmax_leaves;
+    const uint8_t *geo_offsets;               /**< eclipse_geo_*[] (optional, solar) */
+    const uint8_t *geo_members;
+    uint32_t       geo_cell;
+} saros_ctx_t;
+
+/*
+ * Required fields of a saros_ctx_t, for an initialiser in a unit that
+ * includes that dataset's times, info and saros headers, e.g.
+ *   static const saros_ctx_t all = { SAROS_CTX(lunar, LUNAR, all, ALL) };
+ * Optional indexes follow in field order.
+ */
+#define SAROS_CTX(k, K, s, S)                                                  \
+    ECLIPSE_KIND_##K, K##_ECLIPSE_##S##_COUNT,                                 \
+    K##_ECLIPSE_##S##_SAROS_FIRST, K##_ECLIPSE_##S##_SAROS_LAST,               \
+    k##_eclipse_times_##s, k##_eclipse_info_##s,                               \
+    k##_saros_offsets_##s, k##_saros_members_##s,                              \
+    k##_prev_in_series_##s, k##_next_in_series_##s
+
+/**
+ * saros_db_t — solar and lunar datasets mapped from the .db files at run
+ * time by saros_db_open().  Opaque; read it with the saros_db_*() calls.
+ */
+typedef struct saros_db saros_db_t;
+
+/**
+ * saros_db_live_t — the saros_db_t a long-running service answers from,
+ * replaceable by saros_db_live_swap() while readers keep going.  Opaque.
+ */
+typedef struct saros_db_live saros_db_live_t;
+
 /* ── Public API ─────────────────────────────────────────────────────────── */
 
 #ifdef __cplusplus
@@ -202,6 +414,13 @@ eclipse_result_t find_next_solar_eclipse(int64_t timestamp);
  */
 eclipse_result_t find_past_solar_eclipse(int64_t timestamp);
 
+/**
+ * find_closest_solar_eclipse(ts)
+ *   Whichever of the next or past solar eclipse is nearer to ts, from a
+ *   single search.  When equidistant, the future eclipse is returned.
+ */
+eclipse_result_t find_closest_solar_eclipse(int64_t timestamp);
+
 /**
  * find_solar_saros_window(ts, saros_number)
  *   Returns the most recent past eclipse and the next future eclipse within
@@ -209,92 +428,715 @@ eclipse_result_t find_past_solar_eclipse(int64_t timestamp);
  */
 saros_window_t find_solar_saros_window(int64_t timestamp, uint8_t saros_number);
 
-/** Same three functions for lunar eclipses. */
+/**
+ * find_next_solar_eclipse_of(ts, type_mask)
+ * find_past_solar_eclipse_of(ts, type_mask)
+ *   Like find_next/past_solar_eclipse(), but only eclipses whose type bit is
+ *   set in type_mask count, e.g. SOLAR_TYPES_TOTAL or
+ *   SAROS_TYPE_BIT(SOLAR_ECL_Tplus).  One search, then a walk to the first
+ *   match; with SAROS_USE_CLASS_INDEX the walk jumps through per-class
+ *   bitmaps instead of testing every eclipse.  Does not use the cache.
+ */
+eclipse_result_t find_next_solar_eclipse_of(int64_t timestamp, uint32_t type_mask);
+eclipse_result_t find_past_solar_eclipse_of(int64_t timestamp, uint32_t type_mask);
+
+/**
+ * find_next_solar_eclipse_min_duration(ts, secs)
+ * find_past_solar_eclipse_min_duration(ts, secs)
+ *   Like find_next/past_solar_eclipse(), but only eclipses whose
+ *   central_duration is known and at least secs seconds count.  With
+ *   SAROS_USE_DURATION_INDEX the skip over shorter eclipses is a range-max
+ *   tree descent, O(log n); otherwise a linear walk.  Does not use the cache.
+ */
+eclipse_result_t find_next_solar_eclipse_min_duration(int64_t timestamp, uint16_t secs);
+eclipse_result_t find_past_solar_eclipse_min_duration(int64_t timestamp, uint16_t secs);
+
+/**
+ * find_next_solar_eclipse_batch(timestamps, n, out)
+ * find_past_solar_eclipse_batch(timestamps, n, out)
+ *   out[i] = find_next/past_solar_eclipse(timestamps[i]) for i < n.
+ *   Sorted (non-decreasing) input is detected and answered with a single
+ *   merge walk over the dataset, reusing the previous result whenever
+ *   neighbouring timestamps resolve to the same eclipse.  Unsorted input is
+ *   searched SAROS_BATCH_GROUP (default 8) timestamps at a time in
+ *   lock-step, with the probes of all lanes prefetched together.
+ *   Does not touch the lookup cache.
+ */
+void find_next_solar_eclipse_batch(const int64_t *timestamps, size_t n,
+                                   eclipse_result_t *out);
+void find_past_solar_eclipse_batch(const int64_t *timestamps, size_t n,
+                                   eclipse_result_t *out);
+
+/**
+ * find_next_solar_index(ts) / find_past_solar_index(ts) / find_closest_solar_index(ts)
+ *   Same searches as above, returning only the global index of the eclipse
+ *   (SAROS_NO_ECLIPSE if there is none).  Nothing is decoded or copied and
+ *   the lookup cache is not used; read what you need with the accessors:
+ * saros_solar_time(idx)       — timestamp.
+ * saros_solar_type(idx)       — eclipse type.
+ * saros_solar_info(idx)       — fully decoded info.
+ * saros_solar_neighbours(idx, &prev, &next)
+ *                             — global indices of the previous / next eclipse
+ *                               in the same Saros series, or SAROS_NO_ECLIPSE.
+ * saros_solar_result(idx)     — the eclipse_result_t find_*_solar_eclipse()
+ *                               returns for that eclipse.
+ *   idx must be a valid index (not SAROS_NO_ECLIPSE).
+ */
+uint32_t             find_next_solar_index(int64_t timestamp);
+uint32_t             find_past_solar_index(int64_t timestamp);
+uint32_t             find_closest_solar_index(int64_t timestamp);
+int64_t              saros_solar_time(uint32_t idx);
+solar_eclipse_type_t saros_solar_type(uint32_t idx);
+solar_eclipse_info_t saros_solar_info(uint32_t idx);
+void                 saros_solar_neighbours(uint32_t idx, uint32_t *prev, uint32_t *next);
+eclipse_result_t     saros_solar_result(uint32_t idx);
+
+/**
+ * solar_eclipse_range(t0, t1)
+ *   Cursor over the solar eclipses with t0 <= time < t1, in time order.
+ *   Costs one search; stepping and the accessors below are O(1) each.
+ *     eclipse_range_t r = solar_eclipse_range(t0, t1);
+ *     while (solar_range_next(&r))
+ *         use(solar_range_time(&r), solar_range_info(&r));
+ * solar_range_next(r)  — moves to the next eclipse; 0 once the range is done.
+ * solar_range_time(r)  — timestamp of the current eclipse.
+ * solar_range_info(r)  — decoded info of the current eclipse.
+ * solar_range_entry(r) — both of the above as an eclipse_entry_t.
+ * solar_range_next_of(r, type_mask)
+ *   — like solar_range_next(), but skips eclipses whose type bit is not set
+ *     in type_mask (see SAROS_TYPE_BIT).  Reads only the type of the
+ *     skipped eclipses, or only the class bitmaps with SAROS_USE_CLASS_INDEX,
+ *     32 eclipses at a time; the matches are kept in the range.
+ */
+eclipse_range_t      solar_eclipse_range(int64_t t0, int64_t t1);
+int                  solar_range_next(eclipse_range_t *range);
+int64_t              solar_range_time(const eclipse_range_t *range);
+solar_eclipse_info_t solar_range_info(const eclipse_range_t *range);
+eclipse_entry_t      solar_range_entry(const eclipse_range_t *range);
+int                  solar_range_next_of(eclipse_range_t *range, uint32_t type_mask);
+
+/**
+ * find_solar_eclipses_near(lat, lon, radius_km, t0, t1, cb, user)
+ *   Calls cb for every solar eclipse with t0 <= time < t1 whose point of
+ *   greatest eclipse lies within radius_km of (lat, lon), in degrees with
+ *   north and east positive.  Distances are great-circle distances on a
+ *   sphere of SAROS_EARTH_RADIUS_KM.  Returns the number of calls made.
+ *   Only the grid cells that overlap the circle are read, and eclipses
+ *   arrive in time order per cell rather than overall.  Returns 0 unless lat
+ *   is in [-90, 90] and lon is finite; lon is taken modulo 360.
+ *   Only built with SAROS_USE_GEO_INDEX, so the default build needs no libm.
+ */
+uint32_t find_solar_eclipses_near(double lat, double lon, double radius_km,
+                                  int64_t t0, int64_t t1,
+                                  solar_near_fn cb, void *user);
+
+/**
+ * solar_invalidate_cache()
+ *   Drops the cached solar lookup result of every thread.  Only needed if the
+ *   dataset is swapped at runtime; the next call performs a full search.
+ */
+void solar_invalidate_cache(void);
+
+/** Same functions for lunar eclipses. */
 eclipse_result_t find_next_lunar_eclipse(int64_t timestamp);
 eclipse_result_t find_past_lunar_eclipse(int64_t timestamp);
+eclipse_result_t find_closest_lunar_eclipse(int64_t timestamp);
 saros_window_t   find_lunar_saros_window(int64_t timestamp, uint8_t saros_number);
+eclipse_result_t find_next_lunar_eclipse_of(int64_t timestamp, uint32_t type_mask);
+eclipse_result_t find_past_lunar_eclipse_of(int64_t timestamp, uint32_t type_mask);
+eclipse_result_t find_next_lunar_eclipse_min_duration(int64_t timestamp, lunar_phase_t phase,
+                                                      uint16_t secs);
+eclipse_result_t find_past_lunar_eclipse_min_duration(int64_t timestamp, lunar_phase_t phase,
+                                                      uint16_t secs);
+void             find_next_lunar_eclipse_batch(const int64_t *timestamps, size_t n,
+                                               eclipse_result_t *out);
+void             find_past_lunar_eclipse_batch(const int64_t *timestamps, size_t n,
+                                               eclipse_result_t *out);
+uint32_t         find_next_lunar_index(int64_t timestamp);
+uint32_t         find_past_lunar_index(int64_t timestamp);
+uint32_t         find_closest_lunar_index(int64_t timestamp);
+int64_t          saros_lunar_time(uint32_t idx);
+lunar_eclipse_type_t saros_lunar_type(uint32_t idx);
+lunar_eclipse_info_t saros_lunar_info(uint32_t idx);
+void             saros_lunar_neighbours(uint32_t idx, uint32_t *prev, uint32_t *next);
+eclipse_result_t saros_lunar_result(uint32_t idx);
+eclipse_range_t  lunar_eclipse_range(int64_t t0, int64_t t1);
+int              lunar_range_next(eclipse_range_t *range);
+int64_t          lunar_range_time(const eclipse_range_t *range);
+lunar_eclipse_info_t lunar_range_info(const eclipse_range_t *range);
+eclipse_entry_t  lunar_range_entry(const eclipse_range_t *range);
+int              lunar_range_next_of(eclipse_range_t *range, uint32_t type_mask);
+void             lunar_invalidate_cache(void);
 
-#ifdef __cplusplus
-}
-#endif
+/**
+ * Solar and lunar together.  Defined where both kinds are implemented in one
+ * translation unit, or in a unit of their own that defines
+ * SAROS_IMPL_TIMELINE (they only call the functions above).
+ *
+ * find_next_eclipse_any(ts) / find_past_eclipse_any(ts)
+ *   Nearest eclipse of either kind at or after / at or before ts.  One index
+ *   search per kind; only the winner is decoded.  The solar eclipse wins a
+ *   tie.  result.eclipse.valid == 0 if neither kind has one.
+ *
+ * eclipse_timeline(t0, t1)
+ *   Cursor over the solar and lunar eclipses with t0 <= time < t1, merged in
+ *   time order (solar first on a tie).  Costs one search per kind; stepping
+ *   is O(1).
+ *     eclipse_timeline_t tl = eclipse_timeline(t0, t1);
+ *     while (eclipse_timeline_next(&tl))
+ *         use(tl.kind, tl.time, eclipse_timeline_entry(&tl));
+ * eclipse_timeline_next(tl)  — moves to the next eclipse; 0 once both kinds are done.
+ * eclipse_timeline_entry(tl) — the current eclipse as an eclipse_entry_t;
+ *                              info.solar or info.lunar according to tl->kind.
+ */
+eclipse_any_result_t find_next_eclipse_any(int64_t timestamp);
+eclipse_any_result_t find_past_eclipse_any(int64_t timestamp);
+eclipse_timeline_t   eclipse_timeline(int64_t t0, int64_t t1);
+int                  eclipse_timeline_next(eclipse_timeline_t *tl);
+eclipse_entry_t      eclipse_timeline_entry(const eclipse_timeline_t *tl);
 
-/* ── Closest-eclipse helpers (inline, use the functions above) ──────────── */
+/**
+ * Runtime datasets.  Defined in a unit that defines SAROS_IMPL_DB (db_impl.c);
+ * POSIX hosts only.
+ *
+ * saros_db_open(path)
+ *   path is either the eclipses.sdb container or a directory holding
+ *   solar/ and lunar/ {eclipse_times,eclipse_info,saros_offsets,
+ *   saros_members,prev_in_series,next_in_series}.db, as written by
+ *   build_db.py.  The files are mapped read-only and shared, so every
+ *   process opening them shares their pages.  Nothing is copied or
+ *   rebuilt: the lookups read the series index and links in place.  The
+ *   sizes, the series index and the links are checked, and for the
+ *   container also the header and the CRC32C of every section.  The
+ *   container's class, duration and geo sections are used like
+ *   SAROS_USE_CLASS_INDEX, SAROS_USE_DURATION_INDEX and
+ *   SAROS_USE_GEO_INDEX.  A kind that is not there is left empty.
+ *   Returns NULL with errno set if neither kind is there, a file cannot be
+ *   mapped (ENOENT, EACCES, ...) or is malformed or corrupt (EINVAL).
+ * saros_db_close(db)
+ *   Unmaps the files; db and every cursor over it become invalid.
+ * saros_db_count(db, kind)
+ *   Number of eclipses of that kind (0 if it was not found).
+ * saros_db_saros_range(db, kind, &first, &last)
+ *   Saros series covered, e.g. 1 and 180 (both 0 if the kind is empty).
+ *
+ * The lookups mirror the compiled-in API with the handle and an
+ * eclipse_kind_t in front, e.g. saros_db_find_next(db, ECLIPSE_KIND_LUNAR, ts)
+ * is find_next_lunar_eclipse(ts) over the files.  They use the plain binary
+ * search and no lookup cache; the handle is read-only, so any number of
+ * threads may share it.
+ *   saros_db_find_next / _past / _closest, saros_db_saros_window,
+ *   saros_db_find_next_of / _past_of,
+ *   saros_db_find_next_min_duration / _past_min_duration  (phase is ignored
+ *     for solar eclipses, which only have a central duration),
+ *   saros_db_find_next_batch / _past_batch,
+ *   saros_db_next_index / _past_index / _closest_index with the accessors
+ *     saros_db_time, saros_db_type, saros_db_entry, saros_db_neighbours and
+ *     saros_db_result,
+ *   saros_db_range / saros_db_range_next / saros_db_range_next_of
+ *     (read the current eclipse with saros_db_entry(db, kind, r.index)),
+ *   saros_db_find_solar_near.
+ */
+saros_db_t          *saros_db_open(const char *path);
+void                 saros_db_close(saros_db_t *db);
+uint32_t             saros_db_count(const saros_db_t *db, eclipse_kind_t kind);
+void                 saros_db_saros_range(const saros_db_t *db, eclipse_kind_t kind,
+                                          uint8_t *first, uint8_t *last);
+eclipse_result_t     saros_db_find_next(const saros_db_t *db, eclipse_kind_t kind,
+                                        int64_t timestamp);
+eclipse_result_t     saros_db_find_past(const saros_db_t *db, eclipse_kind_t kind,
+                                        int64_t timestamp);
+eclipse_result_t     saros_db_find_closest(const saros_db_t *db, eclipse_kind_t kind,
+                                           int64_t timestamp);
+saros_window_t       saros_db_saros_window(const saros_db_t *db, eclipse_kind_t kind,
+                                           int64_t timestamp, uint8_t saros_number);
+eclipse_result_t     saros_db_find_next_of(const saros_db_t *db, eclipse_kind_t kind,
+                                           int64_t timestamp, uint32_t type_mask);
+eclipse_result_t     saros_db_find_past_of(const saros_db_t *db, eclipse_kind_t kind,
+                                           int64_t timestamp, uint32_t type_mask);
+eclipse_result_t     saros_db_find_next_min_duration(const saros_db_t *db, eclipse_kind_t kind,
+                                                     int64_t timestamp, lunar_phase_t phase,
+                                                     uint16_t secs);
+eclipse_result_t     saros_db_find_past_min_duration(const saros_db_t *db, eclipse_kind_t kind,
+                                                     int64_t timestamp, lunar_phase_t phase,
+                                                     uint16_t secs);
+void                 saros_db_find_next_batch(const saros_db_t *db, eclipse_kind_t kind,
+                                              const int64_t *timestamps, size_t n,
+                                              eclipse_result_t *out);
+void                 saros_db_find_past_batch(const saros_db_t *db, eclipse_kind_t kind,
+                                              const int64_t *timestamps, size_t n,
+                                              eclipse_result_t *out);
+uint32_t             saros_db_next_index(const saros_db_t *db, eclipse_kind_t kind,
+                                         int64_t timestamp);
+uint32_t             saros_db_past_index(const saros_db_t *db, eclipse_kind_t kind,
+                                         int64_t timestamp);
+uint32_t             saros_db_closest_index(const saros_db_t *db, eclipse_kind_t kind,
+                                            int64_t timestamp);
+int64_t              saros_db_time(const saros_db_t *db, eclipse_kind_t kind, uint32_t idx);
+uint8_t              saros_db_type(const saros_db_t *db, eclipse_kind_t kind, uint32_t idx);
+eclipse_entry_t      saros_db_entry(const saros_db_t *db, eclipse_kind_t kind, uint32_t idx);
+void                 saros_db_neighbours(const saros_db_t *db, eclipse_kind_t kind,
+                                         uint32_t idx, uint32_t *prev, uint32_t *next);
+eclipse_result_t     saros_db_result(const saros_db_t *db, eclipse_kind_t kind, uint32_t idx);
+eclipse_range_t      saros_db_range(const saros_db_t *db, eclipse_kind_t kind,
+                                    int64_t t0, int64_t t1);
+int                  saros_db_range_next(eclipse_range_t *range);
+int                  saros_db_range_next_of(const saros_db_t *db, eclipse_kind_t kind,
+                                            eclipse_range_t *range, uint32_t type_mask);
+uint32_t             saros_db_find_solar_near(const saros_db_t *db,
+                                              double lat, double lon, double radius_km,
+                                              int64_t t0, int64_t t1,
+                                              solar_near_fn cb, void *user);
 
 /**
- * find_closest_solar_eclipse(ts)
- *   Returns whichever of the next or past solar eclipse is nearer to ts.
- *   When equidistant, the future eclipse is returned.
+ * Swapping the runtime dataset under running readers.  Same unit as
+ * saros_db_open(); also needs POSIX threads and the GCC __atomic builtins.
+ *
+ * saros_db_live_create(db)
+ *   Takes over an open handle.  NULL with errno set if db is NULL (EINVAL)
+ *   or out of memory; db is then still the caller's.
+ * saros_db_live_acquire(live, &ticket)
+ *   The current handle, valid until saros_db_live_release(live, ticket).
+ *   Never blocks: two atomic increments and a few loads.  Hold it for a
+ *   query or a batch, not for good, since every swap waits for it.
+ * saros_db_live_release(live, ticket)
+ *   Ends the read; the handle must not be used afterwards.
+ * saros_db_live_swap(live, db)
+ *   Hands db to every later acquire, waits until the readers that may
+ *   still hold the previous handle have released it (the grace period),
+ *   then closes it.  Swaps are serialised.  Returns 0, or -1 with errno
+ *   set to EINVAL if db is NULL, so saros_db_live_swap(live,
+ *   saros_db_open(path)) keeps the old data when the new files are bad.
+ *   Calling it while holding a ticket on live waits forever.
+ * saros_db_live_destroy(live)
+ *   Closes the current handle and frees live; nothing may hold a ticket.
+ *
+ *     uint32_t ticket;
+ *     const saros_db_t *db = saros_db_live_acquire(live, &ticket);
+ *     eclipse_result_t r = saros_db_find_next(db, ECLIPSE_KIND_SOLAR, now);
+ *     saros_db_live_release(live, ticket);
  */
-static inline eclipse_result_t find_closest_solar_eclipse(int64_t timestamp)
-{
-    eclipse_result_t nxt = find_next_solar_eclipse(timestamp);
-    eclipse_result_t pst = find_past_solar_eclipse(timestamp);
-    if (!nxt.eclipse.valid) return pst;
-    if (!pst.eclipse.valid) return nxt;
-    int64_t d_nxt = nxt.eclipse.unix_time - timestamp;
-    int64_t d_pst = timestamp - pst.eclipse.unix_time;
-    return (d_pst < d_nxt) ? pst : nxt;
-}
+saros_db_live_t     *saros_db_live_create(saros_db_t *db);
+const saros_db_t    *saros_db_live_acquire(saros_db_live_t *live, uint32_t *ticket);
+void                 saros_db_live_release(saros_db_live_t *live, uint32_t ticket);
+int                  saros_db_live_swap(saros_db_live_t *live, saros_db_t *db);
+void                 saros_db_live_destroy(saros_db_live_t *live);
 
 /**
- * find_closest_lunar_eclipse(ts)
- *   Returns whichever of the next or past lunar eclipse is nearer to ts.
- *   When equidistant, the future eclipse is returned.
+ * Context handles.  Defined in a unit that defines SAROS_IMPL_CTX
+ * (ctx_impl.c), which also exports the generated datasets:
+ *   saros_ctx_solar_modern, saros_ctx_solar_all,
+ *   saros_ctx_lunar_modern, saros_ctx_lunar_all
+ * with their class, duration and geo indexes.  By default these are
+ * ctx_impl.c's own plain copies, so they link beside any layout of the
+ * compiled-in units.  Define SAROS_SHARE_CTX in every unit instead to have
+ * the SOLAR / LUNAR sections export the handle of their slice from the
+ * arrays they already link (plain layout only; it carries the indexes that
+ * unit enabled), and ctx_impl.c then defines only the other slice.
+ *
+ * Each call is the compiled-in one of ctx's kind with ctx in front, e.g.
+ * saros_find_next(&saros_ctx_lunar_all, ts) is find_next_lunar_eclipse(ts)
+ * in a SAROS_USE_ALL build; the compiled-in calls are themselves thin
+ * wrappers that pass their own dataset, and so are the saros_db_*() calls
+ * with one built from the mapped sections.  These use the plain binary search
+ * and no lookup cache, and read ctx only, so they are reentrant.
+ *   saros_find_next / _past / _closest, saros_find_window,
+ *   saros_find_next_of / _past_of,
+ *   saros_find_next_min_duration / _past_min_duration  (phase is ignored
+ *     for solar datasets),
+ *   saros_find_next_batch / _past_batch,
+ *   saros_find_near  (solar datasets; 0 for lunar ones),
+ *   saros_next_index / _past_index / _closest_index with the accessors
+ *     saros_time, saros_type, saros_entry, saros_neighbours, saros_result,
+ *   saros_range / saros_range_next / saros_range_next_of.
  */
-static inline eclipse_result_t find_closest_lunar_eclipse(int64_t timestamp)
-{
-    eclipse_result_t nxt = find_next_lunar_eclipse(timestamp);
-    eclipse_result_t pst = find_past_lunar_eclipse(timestamp);
-    if (!nxt.eclipse.valid) return pst;
-    if (!pst.eclipse.valid) return nxt;
-    int64_t d_nxt = nxt.eclipse.unix_time - timestamp;
-    int64_t d_pst = timestamp - pst.eclipse.unix_time;
-    return (d_pst < d_nxt) ? pst : nxt;
+extern const saros_ctx_t saros_ctx_solar_modern;
+extern const saros_ctx_t saros_ctx_solar_all;
+extern const saros_ctx_t saros_ctx_lunar_modern;
+extern const saros_ctx_t saros_ctx_lunar_all;
+
+eclipse_result_t     saros_find_next(const saros_ctx_t *ctx, int64_t timestamp);
+eclipse_result_t     saros_find_past(const saros_ctx_t *ctx, int64_t timestamp);
+eclipse_result_t     saros_find_closest(const saros_ctx_t *ctx, int64_t timestamp);
+saros_window_t       saros_find_window(const saros_ctx_t *ctx, int64_t timestamp,
+                                       uint8_t saros_number);
+eclipse_result_t     saros_find_next_of(const saros_ctx_t *ctx, int64_t timestamp,
+                                        uint32_t type_mask);
+eclipse_result_t     saros_find_past_of(const saros_ctx_t *ctx, int64_t timestamp,
+                                        uint32_t type_mask);
+eclipse_result_t     saros_find_next_min_duration(const saros_ctx_t *ctx, int64_t timestamp,
+                                                  lunar_phase_t phase, uint16_t secs);
+eclipse_result_t     saros_find_past_min_duration(const saros_ctx_t *ctx, int64_t timestamp,
+                                                  lunar_phase_t phase, uint16_t secs);
+void                 saros_find_next_batch(const saros_ctx_t *ctx, const int64_t *timestamps,
+                                           size_t n, eclipse_result_t *out);
+void                 saros_find_past_batch(const saros_ctx_t *ctx, const int64_t *timestamps,
+                                           size_t n, eclipse_result_t *out);
+uint32_t             saros_find_near(const saros_ctx_t *ctx,
+                                     double lat, double lon, double radius_km,
+                                     int64_t t0, int64_t t1,
+                                     solar_near_fn cb, void *user);
+uint32_t             saros_next_index(const saros_ctx_t *ctx, int64_t timestamp);
+uint32_t             saros_past_index(const saros_ctx_t *ctx, int64_t timestamp);
+uint32_t             saros_closest_index(const saros_ctx_t *ctx, int64_t timestamp);
+int64_t              saros_time(const saros_ctx_t *ctx, uint32_t idx);
+uint8_t              saros_type(const saros_ctx_t *ctx, uint32_t idx);
+eclipse_entry_t      saros_entry(const saros_ctx_t *ctx, uint32_t idx);
+void                 saros_neighbours(const saros_ctx_t *ctx, uint32_t idx,
+                                      uint32_t *prev, uint32_t *next);
+eclipse_result_t     saros_result(const saros_ctx_t *ctx, uint32_t idx);
+eclipse_range_t      saros_range(const saros_ctx_t *ctx, int64_t t0, int64_t t1);
+int                  saros_range_next(eclipse_range_t *range);
+int                  saros_range_next_of(const saros_ctx_t *ctx, eclipse_range_t *range,
+                                         uint32_t type_mask);
+
+#ifdef __cplusplus
 }
+#endif
 
 
 /* ══════════════════════════════════════════════════════════════════════════ *
- * Implementation — compiled only when SAROS_IMPL_SOLAR or SAROS_IMPL_LUNAR  *
- * is defined (typically in the dedicated .c / .cpp translation unit).        *
+ * Implementation — compiled only when SAROS_IMPL_SOLAR, SAROS_IMPL_LUNAR,   *
+ * SAROS_IMPL_DB or SAROS_IMPL_CTX is defined (typically in the dedicated     *
+ * .c / .cpp unit).                                                           *
  * ══════════════════════════════════════════════════════════════════════════ */
-#if defined(SAROS_IMPL_SOLAR) || defined(SAROS_IMPL_LUNAR)
-
-/* Determine which data-slice macros are available.
- * The data headers (eclipse_times_modern.h etc.) define:
- *   ECLIPSE_MODERN_COUNT / ECLIPSE_ALL_COUNT
- *   ECLIPSE_MODERN_SAROS_FIRST / ECLIPSE_ALL_SAROS_FIRST
- *   ECLIPSE_MODERN_SAROS_LAST  / ECLIPSE_ALL_SAROS_LAST
+#if defined(SAROS_IMPL_SOLAR) || defined(SAROS_IMPL_LUNAR) || defined(SAROS_IMPL_DB) || \
+    defined(SAROS_IMPL_CTX)
+
+/* Bindings to the generated data.
+ * The data headers (eclipse_times_modern.h etc.) of kind k / K (solar /
+ * SOLAR or lunar / LUNAR) define:
+ *   K_ECLIPSE_MODERN_COUNT / K_ECLIPSE_ALL_COUNT
+ *   K_ECLIPSE_MODERN_SAROS_FIRST / K_ECLIPSE_ALL_SAROS_FIRST
+ *   K_ECLIPSE_MODERN_SAROS_LAST  / K_ECLIPSE_ALL_SAROS_LAST
  * and declare the arrays:
- *   eclipse_times_modern[] / eclipse_times_all[]
- *   eclipse_info_modern[]  / eclipse_info_all[]
- *   saros_modern[]         / saros_all[]
+ *   k_eclipse_times_modern[] / k_eclipse_times_all[]
+ *   k_eclipse_info_modern[]  / k_eclipse_info_all[]
+ *   (or the k_eclipse_times_packed_*, k_eclipse_info_packed_* and
+ *   k_eclipse_info_columns_* variants, see "Search layout" above)
+ * and, in saros_modern.h / saros_all.h:
+ *   k_saros_offsets_{modern,all}[]  — uint16 CSR row starts, one per series + 1
+ *   k_saros_members_{modern,all}[]  — uint16 global indices, grouped by series
+ *   k_prev_in_series_{modern,all}[] / k_next_in_series_{modern,all}[]
+ * The macros below name them through _SAROS_KIND / _SAROS_KIND_UC, which
+ * the SOLAR and LUNAR sections define around their code, so each section
+ * binds to its own kind's data even when both share this translation unit.
  */
 #ifdef SAROS_USE_ALL
-#  define _SAROS_TIMES_ARR   eclipse_times_all
-#  define _SAROS_INFO_ARR    eclipse_info_all
-#  define _SAROS_SAROS_ARR   saros_all
-#  define _SAROS_COUNT       ECLIPSE_ALL_COUNT
-#  define _SAROS_FIRST       ((uint8_t)ECLIPSE_ALL_SAROS_FIRST)
-#  define _SAROS_LAST        ((uint8_t)ECLIPSE_ALL_SAROS_LAST)
+#  define _SAROS_SLICE     all
+#  define _SAROS_SLICE_UC  ALL
+#else
+#  define _SAROS_SLICE     modern
+#  define _SAROS_SLICE_UC  MODERN
+#endif
+#define _SAROS_SYM__(k, name, s)    k##name##s
+#define _SAROS_SYM_(k, name, s)     _SAROS_SYM__(k, name, s)
+/* _SAROS_SYM(eclipse_times) -> solar_eclipse_times_modern */
+#define _SAROS_SYM(name)            _SAROS_SYM_(_SAROS_KIND, _##name##_, _SAROS_SLICE)
+#define _SAROS_CONST__(k, s, name)  k##_ECLIPSE_##s##name
+#define _SAROS_CONST_(k, s, name)   _SAROS_CONST__(k, s, name)
+/* _SAROS_CONST(COUNT) -> SOLAR_ECLIPSE_MODERN_COUNT */
+#define _SAROS_CONST(name)          _SAROS_CONST_(_SAROS_KIND_UC, _SAROS_SLICE_UC, _##name)
+#define _SAROS_CTX_SYM__(k, s)      saros_ctx_##k##_##s
+#define _SAROS_CTX_SYM_(k, s)       _SAROS_CTX_SYM__(k, s)
+/* _SAROS_CTX_SYM -> saros_ctx_solar_modern, the handle a SAROS_SHARE_CTX
+ * section exports for its own dataset */
+#define _SAROS_CTX_SYM              _SAROS_CTX_SYM_(_SAROS_KIND, _SAROS_SLICE)
+#ifdef SAROS_SHARE_CTX
+#  define _SAROS_CTX_LINKAGE
+#else
+#  define _SAROS_CTX_LINKAGE        static
+#endif
+
+#ifdef SAROS_PACKED_TIMES
+#  define _SAROS_TIMES_ARR   _SAROS_SYM(eclipse_times_packed)
+#else
+#  define _SAROS_TIMES_ARR   _SAROS_SYM(eclipse_times)
+#endif
+#if defined(SAROS_PACKED_INFO)
+#  define _SAROS_INFO_ARR    _SAROS_SYM(eclipse_info_packed)
+#elif defined(SAROS_INFO_COLUMNS)
+#  define _SAROS_INFO_ARR    _SAROS_SYM(eclipse_info_columns)
+#else
+#  define _SAROS_INFO_ARR    _SAROS_SYM(eclipse_info)
+#endif
+#define _SAROS_OFFSETS_ARR   _SAROS_SYM(saros_offsets)
+#define _SAROS_MEMBERS_ARR   _SAROS_SYM(saros_members)
+#define _SAROS_PREV_ARR      _SAROS_SYM(prev_in_series)
+#define _SAROS_NEXT_ARR      _SAROS_SYM(next_in_series)
+#define _SAROS_COUNT         _SAROS_CONST(COUNT)
+#define _SAROS_FIRST         ((uint8_t)_SAROS_CONST(SAROS_FIRST))
+#define _SAROS_LAST          ((uint8_t)_SAROS_CONST(SAROS_LAST))
+
+#ifdef SAROS_LAYOUT_EYTZINGER
+#  define _SAROS_EYTZ_ARR       _SAROS_SYM(eclipse_eytz)
+#  define _SAROS_EYTZ_RANK_ARR  _SAROS_SYM(eclipse_eytz_rank)
+#  define _SAROS_LOWER_BOUND(key) \
+       _eytz_lower_bound(_SAROS_EYTZ_ARR, _SAROS_EYTZ_RANK_ARR, _SAROS_COUNT, (key))
+#  define _SAROS_UPPER_BOUND(key) \
+       _eytz_upper_bound(_SAROS_EYTZ_ARR, _SAROS_EYTZ_RANK_ARR, _SAROS_COUNT, (key))
+#elif defined(SAROS_USE_BUCKET_INDEX)
+#  define _SAROS_BUCKET_ARR     _SAROS_SYM(eclipse_bucket)
+#  define _SAROS_BUCKET_COUNT   _SAROS_CONST(BUCKET_COUNT)
+#  define _SAROS_BUCKET_SHIFT   _SAROS_CONST(BUCKET_SHIFT)
+#  define _SAROS_BUCKET_ORIGIN  _SAROS_CONST(BUCKET_ORIGIN)
+#  define _SAROS_LOWER_BOUND(key) \
+       _bucket_lower_bound(_SAROS_TIMES_ARR, _SAROS_COUNT, _SAROS_BUCKET_ARR, \
+                           _SAROS_BUCKET_COUNT, _SAROS_BUCKET_ORIGIN, \
+                           _SAROS_BUCKET_SHIFT, (key))
+#  define _SAROS_UPPER_BOUND(key) \
+       _bucket_upper_bound(_SAROS_TIMES_ARR, _SAROS_COUNT, _SAROS_BUCKET_ARR, \
+                           _SAROS_BUCKET_COUNT, _SAROS_BUCKET_ORIGIN, \
+                           _SAROS_BUCKET_SHIFT, (key))
+#else
+#  define _SAROS_LOWER_BOUND(key) \
+       _lower_bound_in(_SAROS_TIMES_ARR, _SAROS_COUNT, 0u, _SAROS_COUNT, (key))
+#  define _SAROS_UPPER_BOUND(key) \
+       _upper_bound_in(_SAROS_TIMES_ARR, _SAROS_COUNT, 0u, _SAROS_COUNT, (key))
+#endif
+
+#ifdef SAROS_USE_CLASS_INDEX
+#  define _SAROS_CLASS_ARR      _SAROS_SYM(eclipse_class)
+#else
+#  define _SAROS_CLASS_ARR      ((const uint8_t *)0)
+#endif
+
+#ifdef SAROS_USE_DURATION_INDEX
+#  define _SAROS_DMAX_ARR       _SAROS_SYM(eclipse_dmax)
+#  define _SAROS_DMAX_LEAVES    _SAROS_CONST(DMAX_LEAVES)
+#else
+#  define _SAROS_DMAX_ARR       ((const uint8_t *)0)
+#  define _SAROS_DMAX_LEAVES    0u
+#endif
+
+#ifdef SAROS_USE_GEO_INDEX
+#  define _SAROS_GEO_OFFSETS_ARR  _SAROS_SYM(eclipse_geo_offsets)
+#  define _SAROS_GEO_MEMBERS_ARR  _SAROS_SYM(eclipse_geo_members)
+#  define _SAROS_GEO_CELL         _SAROS_CONST(GEO_CELL)
+#else
+#  define _SAROS_GEO_OFFSETS_ARR  ((const uint8_t *)0)
+#  define _SAROS_GEO_MEMBERS_ARR  ((const uint8_t *)0)
+#  define _SAROS_GEO_CELL         0u
+#endif
+
+/* Eclipse counts per kind, for the helpers shared by both kinds */
+#ifdef SAROS_IMPL_SOLAR
+#  define _SAROS_SOLAR_COUNT    _SAROS_CONST_(SOLAR, _SAROS_SLICE_UC, _COUNT)
+#else
+#  define _SAROS_SOLAR_COUNT    0u
+#endif
+#ifdef SAROS_IMPL_LUNAR
+#  define _SAROS_LUNAR_COUNT    _SAROS_CONST_(LUNAR, _SAROS_SLICE_UC, _COUNT)
+#else
+#  define _SAROS_LUNAR_COUNT    0u
+#endif
+
+#if defined(SAROS_LAYOUT_EYTZINGER) && defined(SAROS_USE_BUCKET_INDEX)
+#  error "SAROS_LAYOUT_EYTZINGER and SAROS_USE_BUCKET_INDEX are alternatives; define one"
+#endif
+#if defined(SAROS_PACKED_TIMES) && \
+    (defined(SAROS_LAYOUT_EYTZINGER) || defined(SAROS_USE_BUCKET_INDEX))
+#  error "SAROS_PACKED_TIMES searches the compressed column; drop the other search layout"
+#endif
+
+#if defined(SAROS_PACKED_INFO) && defined(SAROS_INFO_COLUMNS)
+#  error "SAROS_PACKED_INFO and SAROS_INFO_COLUMNS are alternatives; define one"
+#endif
+
+/* The .db files hold plain timestamps and 10-byte records, which is what the
+ * shared readers decode when no other layout is selected. */
+#if defined(SAROS_IMPL_DB) && \
+    (defined(SAROS_PACKED_TIMES) || defined(SAROS_PACKED_INFO) || defined(SAROS_INFO_COLUMNS))
+#  error "SAROS_IMPL_DB reads the plain .db layout; build it without the packed / column layouts"
+#endif
+#if defined(SAROS_IMPL_DB) && defined(ECLIPSE_USE_PROGMEM)
+#  error "SAROS_IMPL_DB maps files and needs a hosted POSIX target"
+#endif
+/* ctx_impl.c exports the plain arrays, and a saros_ctx_t is read through
+ * the same readers */
+#if defined(SAROS_IMPL_CTX) && \
+    (defined(SAROS_PACKED_TIMES) || defined(SAROS_PACKED_INFO) || defined(SAROS_INFO_COLUMNS))
+#  error "SAROS_IMPL_CTX reads the plain layout; build it without the packed / column layouts"
+#endif
+#if defined(SAROS_SHARE_CTX) && (defined(SAROS_IMPL_SOLAR) || defined(SAROS_IMPL_LUNAR)) && \
+    (defined(SAROS_PACKED_TIMES) || defined(SAROS_PACKED_INFO) || defined(SAROS_INFO_COLUMNS))
+#  error "SAROS_SHARE_CTX exports the plain layout; build it without the packed / column layouts"
+#endif
+
+/* Vector search kernel: hosted x86-64 / AArch64 builds with GCC or Clang. */
+#if !defined(SAROS_NO_SIMD) && !defined(ECLIPSE_USE_PROGMEM) && \
+    !defined(SAROS_PACKED_TIMES) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__aarch64__))
+#  define _SAROS_SIMD 1
+#  if defined(__x86_64__)
+#    include <immintrin.h>
+#  else
+#    include <arm_neon.h>
+#  endif
+#endif
+
+/* Prefetch hint; a no-op where data lives in flash or the compiler lacks it. */
+#if defined(__GNUC__) && !defined(ECLIPSE_USE_PROGMEM)
+#  define _SAROS_PREFETCH(p)  __builtin_prefetch(p)
+#else
+#  define _SAROS_PREFETCH(p)  ((void)0)
+#endif
+
+/* ── Lookup cache ───────────────────────────────────────────────────────── *
+ * Each implementation remembers its last find_next / find_past /
+ * find_closest result along with the inclusive timestamp bracket [lo, hi]
+ * for which that result stays the same.  Polling "next eclipse from now"
+ * then costs two compares.
+ *
+ * The cache is thread-local where the toolchain supports it, so concurrent
+ * callers never share it.  Invalidation bumps a shared generation counter,
+ * which makes every thread's cache miss on its next call.
+ */
+#ifndef SAROS_THREAD_LOCAL
+#  if defined(__AVR__)
+#    define SAROS_THREAD_LOCAL                     /* single-threaded target */
+#  elif defined(__cplusplus) && __cplusplus >= 201103L
+#    define SAROS_THREAD_LOCAL thread_local
+#  elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#    define SAROS_THREAD_LOCAL _Thread_local
+#  elif defined(__GNUC__)
+#    define SAROS_THREAD_LOCAL __thread
+#  elif defined(_MSC_VER)
+#    define SAROS_THREAD_LOCAL __declspec(thread)
+#  else
+#    define SAROS_THREAD_LOCAL
+#  endif
+#endif
+
+#if defined(__GNUC__) && !defined(__AVR__)
+#  define _SAROS_GEN_LOAD(g)  __atomic_load_n(&(g), __ATOMIC_ACQUIRE)
+#  define _SAROS_GEN_BUMP(g)  ((void)__atomic_add_fetch(&(g), 1u, __ATOMIC_RELEASE))
 #else
-#  define _SAROS_TIMES_ARR   eclipse_times_modern
-#  define _SAROS_INFO_ARR    eclipse_info_modern
-#  define _SAROS_SAROS_ARR   saros_modern
-#  define _SAROS_COUNT       ECLIPSE_MODERN_COUNT
-#  define _SAROS_FIRST       ((uint8_t)ECLIPSE_MODERN_SAROS_FIRST)
-#  define _SAROS_LAST        ((uint8_t)ECLIPSE_MODERN_SAROS_LAST)
+#  define _SAROS_GEN_LOAD(g)  (g)
+#  define _SAROS_GEN_BUMP(g)  ((void)++(g))
 #endif
 
+#define _SAROS_CACHE_EMPTY   0u
+#define _SAROS_CACHE_NEXT    1u
+#define _SAROS_CACHE_PAST    2u
+#define _SAROS_CACHE_CLOSEST 3u
+
+typedef struct {
+    int64_t          lo;       /* first timestamp the cached result holds for */
+    int64_t          hi;       /* last  timestamp the cached result holds for */
+    uint32_t         gen;      /* generation counter value when filled */
+    uint8_t          mode;     /* _SAROS_CACHE_EMPTY / _NEXT / _PAST / _CLOSEST */
+    eclipse_result_t result;
+} _saros_cache_t;
+
+static inline int _saros_cache_hit(const _saros_cache_t *c, uint8_t mode,
+                                   uint32_t gen, int64_t timestamp)
+{
+    return c->mode == mode && c->gen == gen &&
+           timestamp >= c->lo && timestamp <= c->hi;
+}
+
 /* ── Low-level PROGMEM / RAM accessors ─────────────────────────────────── */
 
-static inline int64_t _saros_read_time(const uint8_t *arr, uint32_t idx)
+static inline int64_t _saros_read_i64(const uint8_t *p)
 {
-    const uint8_t *p = arr + idx * 8u;
     uint64_t lo = (uint64_t)ECLIPSE_READ_DWORD(p);
     uint64_t hi = (uint64_t)ECLIPSE_READ_DWORD(p + 4u);
     return (int64_t)(lo | (hi << 32));
 }
 
+#ifdef SAROS_PACKED_TIMES
+/*
+ * Block-delta timestamp column (eclipse_times_packed_*[]):
+ *   [0..3]       uint32  byte offset of the block meta words
+ *   [4..7]       uint32  byte offset of the gap bytes
+ *   [8..]        int64   base = first timestamp of each block of 16
+ *   [meta off..] uint32  per block: gap width in bytes (high 8 bits) and
+ *                        start of its gaps relative to the gap bytes
+ *   [gap off..]  gaps to the previous eclipse, one per eclipse that does not
+ *                start a block, in the block's width (1–4 bytes)
+ */
+#define _SAROS_PACKED_BLOCK  16u
+
+static inline uint32_t _packed_gap(const uint8_t *p, uint8_t width)
+{
+    uint32_t v = 0;
+    for (uint8_t b = 0; b < width; b++)
+        v |= (uint32_t)ECLIPSE_READ_BYTE(p + b) << (8u * b);
+    return v;
+}
+
+/* Base timestamp of block 'blk'; returns its first gap and sets its width. */
+static inline const uint8_t *_packed_block(const uint8_t *arr, uint32_t blk,
+                                           int64_t *base, uint8_t *width)
+{
+    uint32_t meta = ECLIPSE_READ_DWORD(arr + ECLIPSE_READ_DWORD(arr) + blk * 4u);
+    *base  = _saros_read_i64(arr + 8u + blk * 8u);
+    *width = (uint8_t)(meta >> 24);
+    return arr + ECLIPSE_READ_DWORD(arr + 4u) + (meta & 0xFFFFFFu);
+}
+
+static inline int64_t _saros_read_time(const uint8_t *arr, uint32_t idx)
+{
+    int64_t t;
+    uint8_t width;
+    const uint8_t *gap = _packed_block(arr, idx / _SAROS_PACKED_BLOCK, &t, &width);
+    for (uint32_t j = idx % _SAROS_PACKED_BLOCK; j > 0u; j--, gap += width)
+        t += (int64_t)_packed_gap(gap, width);
+    return t;
+}
+
+/*
+ * First index in [lo, hi) whose time is >= key (upper: > key), or hi.
+ * Binary search over the bases of the blocks the window covers picks the
+ * block, then its gaps are summed until the bound.
+ */
+static uint32_t _packed_bound(const uint8_t *arr, uint32_t lo, uint32_t hi, int64_t key,
+                              int upper)
+{
+    if (lo >= hi)
+        return lo;
+    /* block first holds lo; the bound is in it or in a later block */
+    uint32_t first = lo / _SAROS_PACKED_BLOCK;
+    uint32_t b_lo = first + 1u, b_hi = (hi + _SAROS_PACKED_BLOCK - 1u) / _SAROS_PACKED_BLOCK;
+    while (b_lo < b_hi) {
+        uint32_t mid = b_lo + (b_hi - b_lo) / 2u;
+        int64_t base = _saros_read_i64(arr + 8u + mid * 8u);
+        if (base < key || (upper && base == key))
+            b_lo = mid + 1u;
+        else
+            b_hi = mid;
+    }
+    /* every eclipse before block b_lo is before the bound; block b_lo-1 holds it */
+    uint32_t idx = (b_lo - 1u) * _SAROS_PACKED_BLOCK;
+    uint32_t end = idx + _SAROS_PACKED_BLOCK;
+    if (end > hi)
+        end = hi;
+    int64_t t;
+    uint8_t width;
+    const uint8_t *gap = _packed_block(arr, b_lo - 1u, &t, &width);
+    for (;;) {
+        if (t > key || (!upper && t == key))
+            return (idx < lo) ? lo : idx;
+        if (++idx >= end)
+            return end;
+        t += (int64_t)_packed_gap(gap, width);
+        gap += width;
+    }
+}
+#else
+static inline int64_t _saros_read_time(const uint8_t *arr, uint32_t idx)
+{
+    return _saros_read_i64(arr + idx * 8u);
+}
+#endif
+
+static inline uint8_t _saros_read_info_byte(const uint8_t *arr, uint32_t idx,
+                                           uint32_t offset)
+{
+    return ECLIPSE_READ_BYTE(arr + idx * ECLIPSE_INFO_SIZE + offset);
+}
+
 static inline void _saros_read_info_raw(const uint8_t *arr, uint32_t idx,
                                         uint8_t out[ECLIPSE_INFO_SIZE])
 {
@@ -303,17 +1145,24 @@ static inline void _saros_read_info_raw(const uint8_t *arr, uint32_t idx,
         out[i] = ECLIPSE_READ_BYTE(p + i);
 }
 
-static void _saros_load_series(const uint8_t *saros_arr,
-                               uint8_t  saros_num,
-                               uint8_t  saros_first,
-                               uint8_t *out_count,
-                               uint16_t out_indices[SAROS_MAX_ECLIPSES])
+/*
+ * The series index is compressed sparse rows: the members of series s are
+ * members[offsets[s - first] .. offsets[s - first + 1]), in time order.
+ */
+static inline void _saros_series(const uint8_t *offsets_arr,
+                                 uint8_t   saros_num,
+                                 uint8_t   saros_first,
+                                 uint32_t *out_begin,
+                                 uint32_t *out_end)
+{
+    const uint8_t *p = offsets_arr + (uint32_t)(saros_num - saros_first) * 2u;
+    *out_begin = ECLIPSE_READ_WORD(p);
+    *out_end   = ECLIPSE_READ_WORD(p + 2u);
+}
+
+static inline uint32_t _saros_member(const uint8_t *members_arr, uint32_t pos)
 {
-    uint32_t offset = (uint32_t)(saros_num - saros_first) * SAROS_RECORD_SIZE;
-    const uint8_t *p = saros_arr + offset;
-    *out_count = ECLIPSE_READ_BYTE(p);
-    for (uint8_t i = 0; i < SAROS_MAX_ECLIPSES; i++)
-        out_indices[i] = ECLIPSE_READ_WORD(p + 2u + (uint32_t)i * 2u);
+    return ECLIPSE_READ_WORD(members_arr + pos * 2u);
 }
 
 /* ── Decoders ───────────────────────────────────────────────────────────── */
@@ -344,6 +1193,163 @@ static inline lunar_eclipse_info_t _decode_lunar(const uint8_t b[ECLIPSE_INFO_SI
     return r;
 }
 
+#ifdef SAROS_PACKED_INFO
+/*
+ * Bit-packed records (eclipse_info_packed_*.h): little-endian bit fields,
+ * least significant first, laid out by SOLAR/LUNAR_INFO_PACKED_FIELDS in
+ * build_db.py.  An all-ones duration field means n/a.
+ */
+#define _SAROS_SOLAR_PACKED_SIZE  8u
+#define _SAROS_LUNAR_PACKED_SIZE  7u
+#define _SAROS_LUNAR_DURATION_S   6u   /* lunar durations are in 0.1 minutes */
+
+static inline uint64_t _saros_read_packed(const uint8_t *arr, uint32_t idx,
+                                          uint32_t size)
+{
+    const uint8_t *p = arr + idx * size;
+    uint64_t v = 0;
+    for (uint32_t i = size; i-- > 0u; )
+        v = (v << 8) | ECLIPSE_READ_BYTE(p + i);
+    return v;
+}
+
+static inline uint32_t _packed_field(uint64_t v, uint32_t shift, uint32_t bits)
+{
+    return (uint32_t)(v >> shift) & ((1u << bits) - 1u);
+}
+
+static inline int16_t _packed_signed(uint64_t v, uint32_t shift, uint32_t bits)
+{
+    uint32_t sign = 1u << (bits - 1u);
+    return (int16_t)((int32_t)(_packed_field(v, shift, bits) ^ sign) - (int32_t)sign);
+}
+
+static inline uint16_t _packed_duration(uint64_t v, uint32_t shift, uint32_t bits,
+                                        uint32_t unit)
+{
+    uint32_t d = _packed_field(v, shift, bits);
+    return d == (1u << bits) - 1u ? 0xFFFFu : (uint16_t)(d * unit);
+}
+
+static inline solar_eclipse_info_t _decode_solar_packed(uint64_t v)
+{
+    solar_eclipse_info_t r;
+    r.saros_number     = (uint8_t)_packed_field(v,  0u,  8u);
+    r.saros_pos        = (uint8_t)_packed_field(v,  8u,  7u);
+    r.ecl_type         = (uint8_t)_packed_field(v, 15u,  5u);
+    r.sun_alt          = (uint8_t)_packed_field(v, 20u,  7u);
+    r.central_duration = _packed_duration(v, 27u, 10u, 1u);
+    r.latitude_deg10   = _packed_signed(v, 37u, 11u);
+    r.longitude_deg10  = _packed_signed(v, 48u, 12u);
+    return r;
+}
+
+static inline lunar_eclipse_info_t _decode_lunar_packed(uint64_t v)
+{
+    lunar_eclipse_info_t r;
+    r.saros_number   = (uint8_t)_packed_field(v,  0u,  8u);
+    r.saros_pos      = (uint8_t)_packed_field(v,  8u,  7u);
+    r.ecl_type       = (uint8_t)_packed_field(v, 15u,  4u);
+    r.pen_duration   = _packed_duration(v, 19u, 12u, _SAROS_LUNAR_DURATION_S);
+    r.par_duration   = _packed_duration(v, 31u, 12u, _SAROS_LUNAR_DURATION_S);
+    r.total_duration = _packed_duration(v, 43u, 11u, _SAROS_LUNAR_DURATION_S);
+    r._pad           = 0;
+    return r;
+}
+#endif /* SAROS_PACKED_INFO */
+
+#ifdef SAROS_INFO_COLUMNS
+/*
+ * Column-split records (eclipse_info_columns_*.h): count uint16 values
+ * for each of three 16-bit columns, then count bytes for each 8-bit
+ * column, count being the kind's number of eclipses.  Solar 16-bit
+ * columns are latitude, longitude and central duration; lunar ones the
+ * penumbral, partial and total durations.
+ */
+#define _SAROS_COL16_COUNT   3u
+#define _SAROS_COL_TYPE      0u
+#define _SAROS_COL_SAROS     1u
+#define _SAROS_COL_POS       2u
+#define _SAROS_COL_SUN_ALT   3u
+
+static inline uint16_t _saros_col16(const uint8_t *arr, uint32_t count,
+                                    uint32_t col, uint32_t idx)
+{
+    return ECLIPSE_READ_WORD(arr + (col * count + idx) * 2u);
+}
+
+static inline const uint8_t *_saros_col8(const uint8_t *arr, uint32_t count, uint32_t col)
+{
+    return arr + (_SAROS_COL16_COUNT * 2u + col) * count;
+}
+#endif /* SAROS_INFO_COLUMNS */
+
+/* Decoded info record / type code of eclipse idx, in any info format. */
+static inline solar_eclipse_info_t _saros_solar_info_at(const uint8_t *info_arr,
+                                                        uint32_t idx)
+{
+#if defined(SAROS_PACKED_INFO)
+    return _decode_solar_packed(_saros_read_packed(info_arr, idx, _SAROS_SOLAR_PACKED_SIZE));
+#elif defined(SAROS_INFO_COLUMNS)
+    const uint32_t n = _SAROS_SOLAR_COUNT;
+    solar_eclipse_info_t r;
+    r.latitude_deg10   = (int16_t)_saros_col16(info_arr, n, 0u, idx);
+    r.longitude_deg10  = (int16_t)_saros_col16(info_arr, n, 1u, idx);
+    r.central_duration = _saros_col16(info_arr, n, 2u, idx);
+    r.saros_number     = ECLIPSE_READ_BYTE(_saros_col8(info_arr, n, _SAROS_COL_SAROS) + idx);
+    r.saros_pos        = ECLIPSE_READ_BYTE(_saros_col8(info_arr, n, _SAROS_COL_POS) + idx);
+    r.ecl_type         = ECLIPSE_READ_BYTE(_saros_col8(info_arr, n, _SAROS_COL_TYPE) + idx);
+    r.sun_alt          = ECLIPSE_READ_BYTE(_saros_col8(info_arr, n, _SAROS_COL_SUN_ALT) + idx);
+    return r;
+#else
+    uint8_t b[ECLIPSE_INFO_SIZE];
+    _saros_read_info_raw(info_arr, idx, b);
+    return _decode_solar(b);
+#endif
+}
+
+static inline lunar_eclipse_info_t _saros_lunar_info_at(const uint8_t *info_arr,
+                                                        uint32_t idx)
+{
+#if defined(SAROS_PACKED_INFO)
+    return _decode_lunar_packed(_saros_read_packed(info_arr, idx, _SAROS_LUNAR_PACKED_SIZE));
+#elif defined(SAROS_INFO_COLUMNS)
+    const uint32_t n = _SAROS_LUNAR_COUNT;
+    lunar_eclipse_info_t r;
+    r.pen_duration   = _saros_col16(info_arr, n, 0u, idx);
+    r.par_duration   = _saros_col16(info_arr, n, 1u, idx);
+    r.total_duration = _saros_col16(info_arr, n, 2u, idx);
+    r.saros_number   = ECLIPSE_READ_BYTE(_saros_col8(info_arr, n, _SAROS_COL_SAROS) + idx);
+    r.saros_pos      = ECLIPSE_READ_BYTE(_saros_col8(info_arr, n, _SAROS_COL_POS) + idx);
+    r.ecl_type       = ECLIPSE_READ_BYTE(_saros_col8(info_arr, n, _SAROS_COL_TYPE) + idx);
+    r._pad           = 0;
+    return r;
+#else
+    uint8_t b[ECLIPSE_INFO_SIZE];
+    _saros_read_info_raw(info_arr, idx, b);
+    return _decode_lunar(b);
+#endif
+}
+
+static inline uint8_t _saros_type_at(const uint8_t *info_arr, uint32_t idx,
+                                     int is_lunar)
+{
+#if defined(SAROS_PACKED_INFO)
+    /* ecl_type sits at bit 15 of both formats: 5 bits solar, 4 bits lunar */
+    const uint8_t *p = info_arr + idx * (is_lunar ? _SAROS_LUNAR_PACKED_SIZE
+                                                  : _SAROS_SOLAR_PACKED_SIZE);
+    uint32_t w = (uint32_t)ECLIPSE_READ_BYTE(p + 1) | ((uint32_t)ECLIPSE_READ_BYTE(p + 2) << 8);
+    return (uint8_t)((w >> 7) & (is_lunar ? 0x0Fu : 0x1Fu));
+#elif defined(SAROS_INFO_COLUMNS)
+    return ECLIPSE_READ_BYTE(_saros_col8(info_arr,
+                                         is_lunar ? _SAROS_LUNAR_COUNT : _SAROS_SOLAR_COUNT,
+                                         _SAROS_COL_TYPE) + idx);
+#else
+    (void)is_lunar;
+    return _saros_read_info_byte(info_arr, idx, 8u);
+#endif
+}
+
 /* ── eclipse_entry builder ─────────────────────────────────────────────── */
 
 static eclipse_entry_t _make_entry(const uint8_t *times_arr,
@@ -355,22 +1361,21 @@ static eclipse_entry_t _make_entry(const uint8_t *times_arr,
     memset(&e, 0, sizeof(e));
     e.global_index = (uint16_t)global_idx;
     e.unix_time    = _saros_read_time(times_arr, global_idx);
-    uint8_t b[ECLIPSE_INFO_SIZE];
-    _saros_read_info_raw(info_arr, global_idx, b);
     if (is_lunar)
-        e.info.lunar = _decode_lunar(b);
+        e.info.lunar = _saros_lunar_info_at(info_arr, global_idx);
     else
-        e.info.solar = _decode_solar(b);
+        e.info.solar = _saros_solar_info_at(info_arr, global_idx);
     e.valid = 1;
     return e;
 }
 
 /* ── Binary search ──────────────────────────────────────────────────────── */
 
-/* First index with value >= key; returns count if all values < key. */
-static uint32_t _lower_bound(const uint8_t *times_arr, uint32_t count, int64_t key)
+#ifndef SAROS_PACKED_TIMES
+/* First index in [lo, hi) with value >= key; returns hi if all values < key. */
+static uint32_t _lower_bound(const uint8_t *times_arr, uint32_t lo, uint32_t hi,
+                             int64_t key)
 {
-    uint32_t lo = 0, hi = count;
     while (lo < hi) {
         uint32_t mid = lo + (hi - lo) / 2u;
         if (_saros_read_time(times_arr, mid) < key)
@@ -381,10 +1386,10 @@ static uint32_t _lower_bound(const uint8_t *times_arr, uint32_t count, int64_t k
     return lo;
 }
 
-/* First index with value > key; element at result-1 is the last <= key. */
-static uint32_t _upper_bound(const uint8_t *times_arr, uint32_t count, int64_t key)
+/* First index in [lo, hi) with value > key; element at result-1 is the last <= key. */
+static uint32_t _upper_bound(const uint8_t *times_arr, uint32_t lo, uint32_t hi,
+                             int64_t key)
 {
-    uint32_t lo = 0, hi = count;
     while (lo < hi) {
         uint32_t mid = lo + (hi - lo) / 2u;
         if (_saros_read_time(times_arr, mid) <= key)
@@ -394,203 +1399,2534 @@ static uint32_t _upper_bound(const uint8_t *times_arr, uint32_t count, int64_t k
     }
     return lo;
 }
-
-/* ── Saros-neighbour lookup ─────────────────────────────────────────────── */
-
-/*
- * Given the focal eclipse's saros_number and saros_pos, load the series and
- * return the immediately preceding and following eclipses within it.
+#endif /* !SAROS_PACKED_TIMES */
+
+/* ── Vector search kernel ───────────────────────────────────────────────── *
+ * A branchless scalar phase halves [lo, hi) until at most eight candidates
+ * remain.  Everything before the window is < key and everything after it is
+ * >= key, so the bound is the window start plus the number of window
+ * elements < key — one vector compare and a popcount.  Elements past the
+ * window (but inside the array) are >= key and never counted, which lets
+ * the kernel always load a full block of eight.
  */
-static void _saros_neighbours(
-    const uint8_t *times_arr,
-    const uint8_t *info_arr,
-    const uint8_t *saros_arr,
-    uint8_t saros_first, uint8_t saros_last,
-    uint8_t saros_num, uint8_t saros_pos,
-    int is_lunar,
-    eclipse_entry_t *out_prev,
-    eclipse_entry_t *out_next)
+#ifdef _SAROS_SIMD
+#  if defined(__x86_64__)
+__attribute__((target("avx2")))
+static uint32_t _simd_count_lt8_avx2(const uint8_t *p, int64_t key)
 {
-    memset(out_prev, 0, sizeof(*out_prev));
-    memset(out_next, 0, sizeof(*out_next));
-
-    if (saros_num < saros_first || saros_num > saros_last)
-        return;
+    __m256i k  = _mm256_set1_epi64x(key);
+    __m256i a  = _mm256_loadu_si256((const __m256i *)(const void *)p);
+    __m256i b  = _mm256_loadu_si256((const __m256i *)(const void *)(p + 32));
+    int     ma = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, a)));
+    int     mb = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, b)));
+    return (uint32_t)__builtin_popcount((unsigned)(ma | (mb << 4)));
+}
 
-    uint8_t  count = 0;
-    uint16_t indices[SAROS_MAX_ECLIPSES];
-    _saros_load_series(saros_arr, saros_num, saros_first, &count, indices);
+__attribute__((target("sse4.2")))
+static uint32_t _simd_count_lt8_sse42(const uint8_t *p, int64_t key)
+{
+    __m128i k = _mm_set1_epi64x(key);
+    int m = 0;
+    for (int i = 0; i < 4; i++) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(const void *)(p + i * 16));
+        m |= _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(k, a))) << (i * 2);
+    }
+    return (uint32_t)__builtin_popcount((unsigned)m);
+}
+
+static uint32_t _simd_count_lt8_scalar(const uint8_t *p, int64_t key)
+{
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < 8u; i++)
+        n += (uint32_t)(_saros_read_time(p, i) < key);
+    return n;
+}
+
+/* The kernel is picked on the first probe, not on every one.  Threads
+ * racing here all store the same pointer. */
+typedef uint32_t (*_saros_count_lt8_fn)(const uint8_t *p, int64_t key);
+
+static uint32_t _simd_count_lt8_pick(const uint8_t *p, int64_t key);
+static _saros_count_lt8_fn _simd_count_lt8_kernel = _simd_count_lt8_pick;
+
+static uint32_t _simd_count_lt8_pick(const uint8_t *p, int64_t key)
+{
+    _saros_count_lt8_fn f = __builtin_cpu_supports("avx2")   ? _simd_count_lt8_avx2
+                          : __builtin_cpu_supports("sse4.2") ? _simd_count_lt8_sse42
+                                                             : _simd_count_lt8_scalar;
+    __atomic_store_n(&_simd_count_lt8_kernel, f, __ATOMIC_RELAXED);
+    return f(p, key);
+}
+#  endif
+
+static inline uint32_t _simd_count_lt8(const uint8_t *p, int64_t key)
+{
+#  if defined(__aarch64__)
+    int64x2_t  k   = vdupq_n_s64(key);
+    uint64x2_t acc = vdupq_n_u64(0);
+    for (int i = 0; i < 4; i++) {
+        int64x2_t a = vld1q_s64((const int64_t *)(const void *)(p + i * 16));
+        acc = vaddq_u64(acc, vshrq_n_u64(vcltq_s64(a, k), 63));
+    }
+    return (uint32_t)vaddvq_u64(acc);
+#  else
+    return __atomic_load_n(&_simd_count_lt8_kernel, __ATOMIC_RELAXED)(p, key);
+#  endif
+}
+
+/* Same contract as _lower_bound(); count is the full array length. */
+static uint32_t _lower_bound_simd(const uint8_t *times_arr, uint32_t count,
+                                  uint32_t lo, uint32_t hi, int64_t key)
+{
+    uint32_t n = hi - lo;
+    while (n > 8u) {
+        uint32_t half = n / 2u;
+        lo += (_saros_read_time(times_arr, lo + half) < key) ? half : 0u;
+        n  -= half;
+    }
+    if (lo + 8u > count)
+        return _lower_bound(times_arr, lo, lo + n, key);
+    return lo + _simd_count_lt8(times_arr + lo * 8u, key);
+}
+
+/* Timestamps are integers, so "<= key" is "< key + 1". */
+static uint32_t _upper_bound_simd(const uint8_t *times_arr, uint32_t count,
+                                  uint32_t lo, uint32_t hi, int64_t key)
+{
+    if (key == INT64_MAX)
+        return _upper_bound(times_arr, lo, hi, key);
+    return _lower_bound_simd(times_arr, count, lo, hi, key + 1);
+}
+#endif /* _SAROS_SIMD */
+
+/* Search [lo, hi) of an array of 'count' timestamps with the best kernel. */
+static inline uint32_t _lower_bound_in(const uint8_t *times_arr, uint32_t count,
+                                       uint32_t lo, uint32_t hi, int64_t key)
+{
+#if defined(SAROS_PACKED_TIMES)
+    (void)count;
+    return _packed_bound(times_arr, lo, hi, key, 0);
+#elif defined(_SAROS_SIMD)
+    return _lower_bound_simd(times_arr, count, lo, hi, key);
+#else
+    (void)count;
+    return _lower_bound(times_arr, lo, hi, key);
+#endif
+}
+
+static inline uint32_t _upper_bound_in(const uint8_t *times_arr, uint32_t count,
+                                       uint32_t lo, uint32_t hi, int64_t key)
+{
+#if defined(SAROS_PACKED_TIMES)
+    (void)count;
+    return _packed_bound(times_arr, lo, hi, key, 1);
+#elif defined(_SAROS_SIMD)
+    return _upper_bound_simd(times_arr, count, lo, hi, key);
+#else
+    (void)count;
+    return _upper_bound(times_arr, lo, hi, key);
+#endif
+}
+
+/* ── Bucketed time index ────────────────────────────────────────────────── *
+ * bucket_arr[b] is the first global index whose timestamp is at or after
+ * origin + (b << shift), with bucket_arr[nbuckets] == count.  Both bounds of
+ * a key in bucket b therefore lie in [bucket_arr[b], bucket_arr[b + 1]], so
+ * one table read replaces the first ~12 probes of the binary search.
+ */
+#ifdef SAROS_USE_BUCKET_INDEX
+static inline void _bucket_range(const uint8_t *bucket_arr, uint32_t nbuckets,
+                                 int64_t origin, uint8_t shift, uint32_t count,
+                                 int64_t key, uint32_t *lo, uint32_t *hi)
+{
+    if (key < origin) {
+        *lo = *hi = 0u;
+        return;
+    }
+    uint64_t b = ((uint64_t)key - (uint64_t)origin) >> shift;
+    if (b >= nbuckets) {
+        *lo = *hi = count;
+        return;
+    }
+    const uint8_t *p = bucket_arr + (uint32_t)b * 2u;
+    *lo = ECLIPSE_READ_WORD(p);
+    *hi = ECLIPSE_READ_WORD(p + 2u);
+}
+
+static uint32_t _bucket_lower_bound(const uint8_t *times_arr, uint32_t count,
+                                    const uint8_t *bucket_arr, uint32_t nbuckets,
+                                    int64_t origin, uint8_t shift, int64_t key)
+{
+    uint32_t lo, hi;
+    _bucket_range(bucket_arr, nbuckets, origin, shift, count, key, &lo, &hi);
+    return _lower_bound_in(times_arr, count, lo, hi, key);
+}
+
+static uint32_t _bucket_upper_bound(const uint8_t *times_arr, uint32_t count,
+                                    const uint8_t *bucket_arr, uint32_t nbuckets,
+                                    int64_t origin, uint8_t shift, int64_t key)
+{
+    uint32_t lo, hi;
+    _bucket_range(bucket_arr, nbuckets, origin, shift, count, key, &lo, &hi);
+    return _upper_bound_in(times_arr, count, lo, hi, key);
+}
+#endif /* SAROS_USE_BUCKET_INDEX */
+
+#if defined(SAROS_IMPL_SOLAR) || defined(SAROS_IMPL_LUNAR)
+/* Smallest timestamp at least as close to b as to a (a <= b). */
+static inline int64_t _saros_midpoint_up(int64_t a, int64_t b)
+{
+    return a + (int64_t)(((uint64_t)b - (uint64_t)a + 1u) / 2u);
+}
+
+/*
+ * Fill the cache after a search.  'bound' is the _lower_bound() result for
+ * _SAROS_CACHE_NEXT, the _upper_bound() result for _SAROS_CACHE_PAST and the
+ * winning index for _SAROS_CACHE_CLOSEST; the bracket is every timestamp for
+ * which that search returns the same bound:
+ *   next    : (t[bound-1], t[bound]]
+ *   past    : [t[bound-1], t[bound])
+ *   closest : from the midpoint with t[bound-1] to just before the one with
+ *             t[bound+1]
+ */
+static void _saros_cache_fill(_saros_cache_t *c, uint8_t mode, uint32_t gen,
+                              const uint8_t *times_arr, uint32_t count,
+                              uint32_t bound, const eclipse_result_t *r)
+{
+    if (mode == _SAROS_CACHE_NEXT) {
+        c->lo = (bound > 0u)   ? _saros_read_time(times_arr, bound - 1u) + 1 : INT64_MIN;
+        c->hi = (bound < count) ? _saros_read_time(times_arr, bound)          : INT64_MAX;
+    } else if (mode == _SAROS_CACHE_CLOSEST) {
+        int64_t t = (count > 0u) ? _saros_read_time(times_arr, bound) : 0;
+        c->lo = (bound > 0u)
+              ? _saros_midpoint_up(_saros_read_time(times_arr, bound - 1u), t)
+              : INT64_MIN;
+        c->hi = (bound + 1u < count)
+              ? _saros_midpoint_up(t,
+                                   _saros_read_time(times_arr, bound + 1u)) - 1
+              : INT64_MAX;
+    } else {
+        c->lo = (bound > 0u)   ? _saros_read_time(times_arr, bound - 1u)     : INT64_MIN;
+        c->hi = (bound < count) ? _saros_read_time(times_arr, bound) - 1      : INT64_MAX;
+    }
+    c->gen    = gen;
+    c->mode   = mode;
+    c->result = *r;
+}
+#endif /* SAROS_IMPL_SOLAR || SAROS_IMPL_LUNAR */
+
+/* ── Eytzinger search ───────────────────────────────────────────────────── *
+ * eytz_arr holds the timestamps in BFS order at 1-based slots 1..count
+ * (children of slot k are 2k and 2k+1); rank_arr maps each slot back to its
+ * global index, with rank_arr[0] == count.  The descent is branchless: every
+ * step appends one comparison bit to k.  When it falls off the tree the
+ * answer is the last slot where we went left, i.e. k with its trailing
+ * one-bits and the following zero stripped.
+ *
+ * Slot 8k starts a 64-byte line, so prefetching it brings in the whole
+ * level three steps below the current node.
+ */
+static inline uint32_t _saros_ctz32(uint32_t x)
+{
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_ctz(x);
+#else
+    uint32_t n = 0;
+    while (!(x & 1u)) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+/* Index of the highest set bit; x != 0. */
+static inline uint32_t _saros_log2_32(uint32_t x)
+{
+#if defined(__GNUC__)
+    return 31u - (uint32_t)__builtin_clz(x);
+#else
+    uint32_t n = 0;
+    while (x >>= 1) n++;
+    return n;
+#endif
+}
+
+#ifdef SAROS_LAYOUT_EYTZINGER
+
+static uint32_t _eytz_lower_bound(const uint8_t *eytz_arr, const uint8_t *rank_arr,
+                                  uint32_t count, int64_t key)
+{
+    uint32_t k = 1u;
+    while (k <= count) {
+        _SAROS_PREFETCH(eytz_arr + (uint32_t)(k * 8u) * 8u);
+        k = 2u * k + (uint32_t)(_saros_read_time(eytz_arr, k) < key);
+    }
+    k >>= _saros_ctz32(~k) + 1u;
+    return ECLIPSE_READ_WORD(rank_arr + k * 2u);
+}
+
+static uint32_t _eytz_upper_bound(const uint8_t *eytz_arr, const uint8_t *rank_arr,
+                                  uint32_t count, int64_t key)
+{
+    uint32_t k = 1u;
+    while (k <= count) {
+        _SAROS_PREFETCH(eytz_arr + (uint32_t)(k * 8u) * 8u);
+        k = 2u * k + (uint32_t)(_saros_read_time(eytz_arr, k) <= key);
+    }
+    k >>= _saros_ctz32(~k) + 1u;
+    return ECLIPSE_READ_WORD(rank_arr + k * 2u);
+}
+#endif /* SAROS_LAYOUT_EYTZINGER */
+
+/* ── Saros-neighbour lookup ─────────────────────────────────────────────── */
+
+/*
+ * prev_in_series[] / next_in_series[] hold, for every eclipse, the global
+ * index of its neighbours in the same Saros series (0xFFFF = none), so
+ * resolving them costs one word read each.
+ */
+#define _SAROS_LINK_NONE  0xFFFFu
+
+static inline uint32_t _saros_link(const uint8_t *link_arr, uint32_t idx)
+{
+    uint16_t v = ECLIPSE_READ_WORD(link_arr + idx * 2u);
+    return (v == _SAROS_LINK_NONE) ? SAROS_NO_ECLIPSE : v;
+}
+
+/* The immediately preceding and following eclipses of the focal one's series. */
+static void _saros_neighbours(
+    const uint8_t *times_arr,
+    const uint8_t *info_arr,
+    const uint8_t *prev_arr,
+    const uint8_t *next_arr,
+    uint32_t focal_idx,
+    int is_lunar,
+    eclipse_entry_t *out_prev,
+    eclipse_entry_t *out_next)
+{
+    uint32_t prev = _saros_link(prev_arr, focal_idx);
+    uint32_t next = _saros_link(next_arr, focal_idx);
+    if (prev != SAROS_NO_ECLIPSE)
+        *out_prev = _make_entry(times_arr, info_arr, prev, is_lunar);
+    else
+        memset(out_prev, 0, sizeof(*out_prev));
+    if (next != SAROS_NO_ECLIPSE)
+        *out_next = _make_entry(times_arr, info_arr, next, is_lunar);
+    else
+        memset(out_next, 0, sizeof(*out_next));
+}
+
+/* ── Batch lookups ──────────────────────────────────────────────────────── */
+
+static int _saros_is_sorted(const int64_t *timestamps, size_t n)
+{
+    for (size_t i = 1; i < n; i++)
+        if (timestamps[i] < timestamps[i - 1u])
+            return 0;
+    return 1;
+}
+
+/*
+ * Move a lower / upper bound found for an earlier key forward to the bound
+ * of a larger key.  Dense queries resolve within a few linear steps; when
+ * the walk does not reach the key quickly, the rest is a bounded search.
+ */
+#define _SAROS_MERGE_STEPS 8u
+
+static uint32_t _saros_advance_lower(const uint8_t *times_arr, uint32_t count,
+                                     uint32_t from, int64_t key)
+{
+    for (uint32_t step = 0; step < _SAROS_MERGE_STEPS; step++, from++)
+        if (from >= count || _saros_read_time(times_arr, from) >= key)
+            return from;
+    return _lower_bound_in(times_arr, count, from, count, key);
+}
+
+static uint32_t _saros_advance_upper(const uint8_t *times_arr, uint32_t count,
+                                     uint32_t from, int64_t key)
+{
+    for (uint32_t step = 0; step < _SAROS_MERGE_STEPS; step++, from++)
+        if (from >= count || _saros_read_time(times_arr, from) > key)
+            return from;
+    return _upper_bound_in(times_arr, count, from, count, key);
+}
+
+/*
+ * Group-prefetched search for unsorted batches.  Up to SAROS_BATCH_GROUP
+ * independent searches over the same array run in lock-step; since they all
+ * start from the same length, every round has the same step.  Each round
+ * first prefetches the probe of every lane and only then compares them, so
+ * the cache misses of the lanes overlap instead of queueing behind each
+ * other.  'upper' selects upper-bound (<=) instead of lower-bound (<).
+ */
+#ifndef SAROS_BATCH_GROUP
+#  define SAROS_BATCH_GROUP 8u
+#endif
+
+static void _saros_bound_group(const uint8_t *times_arr, uint32_t count,
+                               const int64_t *keys, uint32_t lanes, int upper,
+                               uint32_t out[SAROS_BATCH_GROUP])
+{
+#ifdef SAROS_PACKED_TIMES
+    /* no random access into the compressed column; search lane by lane */
+    for (uint32_t i = 0; i < lanes; i++)
+        out[i] = upper ? _upper_bound_in(times_arr, count, 0u, count, keys[i])
+                       : _lower_bound_in(times_arr, count, 0u, count, keys[i]);
+#else
+    uint32_t base[SAROS_BATCH_GROUP];
+    for (uint32_t i = 0; i < lanes; i++)
+        base[i] = 0u;
+    if (count == 0u) {
+        for (uint32_t i = 0; i < lanes; i++)
+            out[i] = 0u;
+        return;
+    }
+
+    uint32_t n = count;
+    while (n > 1u) {
+        uint32_t half = n / 2u;
+        for (uint32_t i = 0; i < lanes; i++)
+            _SAROS_PREFETCH(times_arr + (base[i] + half) * 8u);
+        for (uint32_t i = 0; i < lanes; i++) {
+            int64_t t = _saros_read_time(times_arr, base[i] + half);
+            base[i] += ((t < keys[i]) | (upper & (t == keys[i]))) ? half : 0u;
+        }
+        n -= half;
+    }
+    for (uint32_t i = 0; i < lanes; i++) {
+        int64_t t = _saros_read_time(times_arr, base[i]);
+        out[i] = base[i] + (uint32_t)((t < keys[i]) | (upper & (t == keys[i])));
+    }
+#endif
+}
+
+/* Focal eclipse for a search bound, or UINT32_MAX if there is none. */
+static inline uint32_t _saros_batch_focal(uint8_t mode, uint32_t bound, uint32_t count)
+{
+    if (mode == _SAROS_CACHE_NEXT)
+        return (bound < count) ? bound : UINT32_MAX;
+    return (bound > 0u) ? bound - 1u : UINT32_MAX;
+}
+
+/*
+ * Shared driver of the find_*_batch() functions.  Sorted input is answered
+ * with one merge walk over the times array; consecutive timestamps that
+ * resolve to the same eclipse copy the previous result instead of decoding
+ * it and its Saros neighbours again.  Unsorted input is searched
+ * SAROS_BATCH_GROUP timestamps at a time with _saros_bound_group().
+ * build(ctx, idx) makes the result for eclipse idx.
+ */
+static void _saros_batch(const uint8_t *times_arr, uint32_t count,
+                         const int64_t *timestamps, size_t n, uint8_t mode,
+                         eclipse_result_t (*build)(const void *, uint32_t),
+                         const void *ctx, eclipse_result_t *out)
+{
+    if (!_saros_is_sorted(timestamps, n)) {
+        uint32_t bounds[SAROS_BATCH_GROUP];
+        for (size_t i = 0; i < n; i += SAROS_BATCH_GROUP) {
+            uint32_t lanes = (n - i < SAROS_BATCH_GROUP) ? (uint32_t)(n - i)
+                                                         : SAROS_BATCH_GROUP;
+            _saros_bound_group(times_arr, count, timestamps + i, lanes,
+                               mode == _SAROS_CACHE_PAST, bounds);
+            for (uint32_t j = 0; j < lanes; j++) {
+                uint32_t focal = _saros_batch_focal(mode, bounds[j], count);
+                if (focal == UINT32_MAX)
+                    memset(&out[i + j], 0, sizeof(out[i + j]));
+                else
+                    out[i + j] = build(ctx, focal);
+            }
+        }
+        return;
+    }
+
+    uint32_t bound = 0, prev_focal = UINT32_MAX;
+    for (size_t i = 0; i < n; i++) {
+        if (mode == _SAROS_CACHE_NEXT)
+            bound = _saros_advance_lower(times_arr, count, bound, timestamps[i]);
+        else
+            bound = _saros_advance_upper(times_arr, count, bound, timestamps[i]);
+        uint32_t focal = _saros_batch_focal(mode, bound, count);
+        if (i > 0u && focal == prev_focal)
+            out[i] = out[i - 1u];
+        else if (focal == UINT32_MAX)
+            memset(&out[i], 0, sizeof(out[i]));
+        else
+            out[i] = build(ctx, focal);
+        prev_focal = focal;
+    }
+}
+
+/* ── Closest lookup ─────────────────────────────────────────────────────── */
+
+/*
+ * Picks the nearer of the two eclipses around the lower bound 'idx' of ts:
+ * idx itself (at or after ts) and idx-1 (before ts).  Ties go to idx.
+ * Returns UINT32_MAX only for an empty dataset.
+ */
+static inline uint32_t _saros_closest(const uint8_t *times_arr, uint32_t count,
+                                      uint32_t idx, int64_t ts)
+{
+    if (idx >= count)
+        return (count > 0u) ? count - 1u : UINT32_MAX;
+    if (idx == 0u)
+        return 0u;
+    /* t[idx-1] < ts <= t[idx], so neither difference can overflow */
+    int64_t d_nxt = _saros_read_time(times_arr, idx) - ts;
+    int64_t d_pst = ts - _saros_read_time(times_arr, idx - 1u);
+    return (d_pst < d_nxt) ? idx - 1u : idx;
+}
+
+/* ── Range iteration ────────────────────────────────────────────────────── */
+
+/* eclipse_range_t.of_set: the exact flag of _class_set() beside the set */
+#define _SAROS_CLASS_EXACT 0x80000000u
+
+static inline eclipse_range_t _saros_range(uint32_t begin, uint32_t end)
+{
+    eclipse_range_t r;
+    r.next    = begin;
+    r.end     = (end > begin) ? end : begin;
+    r.index   = UINT32_MAX;
+    r.of_mask = 0u;                      /* no classes, exact: matches nothing */
+    r.of_set  = _SAROS_CLASS_EXACT;
+    r.of_word = UINT32_MAX;
+    r.of_bits = 0u;
+    return r;
+}
+
+static inline int _saros_range_next(eclipse_range_t *range)
+{
+    if (range->next >= range->end)
+        return 0;
+    range->index = range->next++;
+    return 1;
+}
+
+/* ── Type filter ────────────────────────────────────────────────────────── */
+
+static inline int _saros_type_in(const uint8_t *info_arr, uint32_t idx,
+                                 uint32_t type_mask, int is_lunar)
+{
+    return (type_mask >> (_saros_type_at(info_arr, idx, is_lunar) & 31u)) & 1u;
+}
+
+/*
+ * Class bitmaps (eclipse_class_*.h): for each class c, (count + 31) / 32
+ * uint32 words with bit i set when eclipse i is of class c.  class_set
+ * selects the classes to OR together.
+ */
+static inline uint32_t _class_word(const uint8_t *class_arr, uint32_t words,
+                                   uint32_t class_set, uint32_t w)
+{
+    uint32_t v = 0;
+    for (; class_set; class_set &= class_set - 1u)
+        v |= ECLIPSE_READ_DWORD(class_arr + (_saros_ctz32(class_set) * words + w) * 4u);
+    return v;
+}
+
+/* Type mask of each class bitmap in eclipse_class_*.h, in bitmap order,
+ * and the number of classes; indexed by eclipse_kind_t */
+static const uint32_t _saros_class_types[2][4] = {
+    { SOLAR_TYPES_ANNULAR, SOLAR_TYPES_HYBRID, SOLAR_TYPES_PARTIAL, SOLAR_TYPES_TOTAL },
+    { LUNAR_TYPES_PENUMBRAL, LUNAR_TYPES_PARTIAL, LUNAR_TYPES_TOTAL, 0u },
+};
+static const uint32_t _saros_classes[2] = { 4u, 3u };
+
+/*
+ * Classes whose types overlap type_mask; class_types[c] is the mask of
+ * class c.  *exact is set when those classes hold no other types, so their
+ * members need no type check.
+ */
+static inline uint32_t _class_set(const uint32_t *class_types, uint32_t nclasses,
+                                  uint32_t type_mask, int *exact)
+{
+    uint32_t set = 0, covered = 0;
+    for (uint32_t c = 0; c < nclasses; c++)
+        if (class_types[c] & type_mask) {
+            set     |= 1u << c;
+            covered |= class_types[c];
+        }
+    *exact = (covered & ~type_mask) == 0u;
+    return set;
+}
+
+/*
+ * First index in [idx, end) whose type bit is set in type_mask, or end.
+ * Without class bitmaps (class_arr == NULL) every type is tested; with
+ * SAROS_INFO_COLUMNS that walks the type column one byte per eclipse.
+ * With them, set bits of the overlapping classes are found a word at a
+ * time, and only those candidates have their type checked (none at all
+ * when exact).
+ */
+static uint32_t _saros_next_of(const uint8_t *info_arr, const uint8_t *class_arr,
+                               uint32_t class_set, int exact, uint32_t count,
+                               uint32_t idx, uint32_t end,
+                               uint32_t type_mask, int is_lunar)
+{
+    if (!class_arr) {
+        for (; idx < end; idx++)
+            if (_saros_type_in(info_arr, idx, type_mask, is_lunar))
+                return idx;
+        return end;
+    }
+    uint32_t words = (count + 31u) / 32u;
+    while (idx < end) {
+        uint32_t w    = idx / 32u;
+        uint32_t bits = _class_word(class_arr, words, class_set, w) & (~0u << (idx % 32u));
+        while (!bits) {
+            if (++w >= words)
+                return end;
+            bits = _class_word(class_arr, words, class_set, w);
+        }
+        idx = w * 32u + _saros_ctz32(bits);
+        if (idx >= end || exact || _saros_type_in(info_arr, idx, type_mask, is_lunar))
+            break;
+        idx++;
+    }
+    return (idx < end) ? idx : end;
+}
+
+/* Last index before idx whose type bit is set in type_mask, or UINT32_MAX. */
+static uint32_t _saros_past_of(const uint8_t *info_arr, const uint8_t *class_arr,
+                               uint32_t class_set, int exact, uint32_t count,
+                               uint32_t idx, uint32_t type_mask, int is_lunar)
+{
+    if (!class_arr) {
+        while (idx-- > 0u)
+            if (_saros_type_in(info_arr, idx, type_mask, is_lunar))
+                return idx;
+        return UINT32_MAX;
+    }
+    uint32_t words = (count + 31u) / 32u;
+    while (idx-- > 0u) {
+        uint32_t w    = idx / 32u;
+        uint32_t bits = _class_word(class_arr, words, class_set, w) &
+                        (~0u >> (31u - idx % 32u));
+        while (!bits) {
+            if (w-- == 0u)
+                return UINT32_MAX;
+            bits = _class_word(class_arr, words, class_set, w);
+        }
+        idx = w * 32u + _saros_log2_32(bits);
+        if (exact || _saros_type_in(info_arr, idx, type_mask, is_lunar))
+            return idx;
+    }
+    return UINT32_MAX;
+}
+
+/*
+ * Matches of type_mask among eclipses 32*w .. 32*w+31, cut at end: bit i
+ * for eclipse 32*w + i.  Without class bitmaps every type is tested, with
+ * no branch per eclipse; with them only members of the classes in
+ * class_set are, and none when exact.
+ */
+static inline uint32_t _saros_match_word(const uint8_t *info_arr, const uint8_t *class_arr,
+                                         uint32_t class_set, int exact, uint32_t count,
+                                         uint32_t w, uint32_t end, uint32_t type_mask,
+                                         int is_lunar)
+{
+    uint32_t base = w * 32u, n = (end - base < 32u) ? end - base : 32u;
+    uint32_t bits = 0;
+    if (!class_arr) {
+        for (uint32_t i = 0; i < n; i++)
+            bits |= (uint32_t)_saros_type_in(info_arr, base + i, type_mask, is_lunar) << i;
+        return bits;
+    }
+    uint32_t cand = _class_word(class_arr, (count + 31u) / 32u, class_set, w);
+    if (n < 32u)
+        cand &= (1u << n) - 1u;
+    if (exact)
+        return cand;
+    for (; cand; cand &= cand - 1u)
+        if (_saros_type_in(info_arr, base + _saros_ctz32(cand), type_mask, is_lunar))
+            bits |= cand & (0u - cand);
+    return bits;
+}
+
+/*
+ * One step of *_range_next_of().  The range keeps the matches of one
+ * 32-eclipse word, so a step is usually a mask and a count of trailing
+ * zeros; a new word is read when the cursor leaves the old one, and the
+ * class set is worked out again only when type_mask changes.
+ */
+static inline int _saros_range_next_of(eclipse_range_t *range, const uint8_t *info_arr,
+                                       const uint8_t *class_arr, uint32_t count,
+                                       uint32_t type_mask, int is_lunar)
+{
+    if (range->of_mask != type_mask) {
+        int exact = 1;
+        uint32_t set = 0;
+        if (class_arr)
+            set = _class_set(_saros_class_types[is_lunar], _saros_classes[is_lunar],
+                             type_mask, &exact);
+        range->of_mask = type_mask;
+        range->of_set  = set | (exact ? _SAROS_CLASS_EXACT : 0u);
+        range->of_word = UINT32_MAX;
+    }
+    while (range->next < range->end) {
+        uint32_t w = range->next / 32u;
+        if (range->of_word != w) {
+            range->of_bits = _saros_match_word(info_arr, class_arr,
+                                               range->of_set & ~_SAROS_CLASS_EXACT,
+                                               (range->of_set & _SAROS_CLASS_EXACT) != 0u,
+                                               count, w, range->end, type_mask, is_lunar);
+            range->of_word = w;
+        }
+        uint32_t bits = range->of_bits & (~0u << (range->next % 32u));
+        if (bits) {
+            range->index = w * 32u + _saros_ctz32(bits);
+            range->next  = range->index + 1u;
+            return 1;
+        }
+        range->next = (w + 1u) * 32u;
+    }
+    range->next = range->end;
+    return 0;
+}
+
+/* ── Duration filter ────────────────────────────────────────────────────── */
+
+/* Key of a duration in the range-max trees: seconds + 1, 0 for n/a. */
+static inline uint32_t _duration_key(uint16_t secs)
+{
+    return (secs == 0xFFFFu) ? 0u : (uint32_t)secs + 1u;
+}
+
+/* Duration key of eclipse idx: solar central, or lunar pen / par / total. */
+static inline uint32_t _saros_duration_at(const uint8_t *info_arr, uint32_t idx,
+                                          int is_lunar, uint32_t field)
+{
+    if (!is_lunar)
+        return _duration_key(_saros_solar_info_at(info_arr, idx).central_duration);
+    lunar_eclipse_info_t li = _saros_lunar_info_at(info_arr, idx);
+    return _duration_key(field == 0u ? li.pen_duration
+                       : field == 1u ? li.par_duration : li.total_duration);
+}
+
+/*
+ * Range-max trees (eclipse_dmax_*.h): per duration field an implicit tree of
+ * 2 * leaves uint16 nodes, root at 1, leaf leaves + b holding the largest
+ * key of eclipses [b * _SAROS_DMAX_BLOCK, (b + 1) * _SAROS_DMAX_BLOCK).
+ */
+#define _SAROS_DMAX_BLOCK 16u
+
+static inline uint32_t _dmax_node(const uint8_t *tree, uint32_t v)
+{
+    return ECLIPSE_READ_WORD(tree + v * 2u);
+}
+
+/* First block >= b whose max key is >= key, or UINT32_MAX. */
+static uint32_t _dmax_first(const uint8_t *tree, uint32_t leaves, uint32_t b,
+                            uint32_t key)
+{
+    if (b >= leaves)
+        return UINT32_MAX;
+    uint32_t v = leaves + b;
+    while (_dmax_node(tree, v) < key) {
+        /* climb past right children, then step to the right neighbour */
+        while (v & 1u) {
+            if (v == 1u)
+                return UINT32_MAX;
+            v >>= 1;
+        }
+        v++;
+    }
+    while (v < leaves) {
+        v <<= 1;
+        if (_dmax_node(tree, v) < key)
+            v++;
+    }
+    return v - leaves;
+}
+
+/* Last block <= b whose max key is >= key, or UINT32_MAX. */
+static uint32_t _dmax_last(const uint8_t *tree, uint32_t leaves, uint32_t b,
+                           uint32_t key)
+{
+    uint32_t v = leaves + b;
+    while (_dmax_node(tree, v) < key) {
+        /* climb past left children, then step to the left neighbour */
+        while (!(v & 1u))
+            v >>= 1;
+        if (v == 1u)
+            return UINT32_MAX;
+        v--;
+    }
+    while (v < leaves) {
+        v = 2u * v + 1u;
+        if (_dmax_node(tree, v) < key)
+            v--;
+    }
+    return v - leaves;
+}
+
+/*
+ * First index >= idx whose duration field is known and >= secs, or count.
+ * Without a tree (dmax_arr == NULL) every eclipse is tested.  With one, the
+ * rest of idx's block is tested, then the tree names the next block that
+ * holds a match.
+ */
+static uint32_t _saros_next_min_duration(const uint8_t *info_arr,
+                                         const uint8_t *dmax_arr, uint32_t leaves,
+                                         uint32_t count, uint32_t idx,
+                                         int is_lunar, uint32_t field, uint16_t secs)
+{
+    uint32_t key = (uint32_t)secs + 1u;
+    uint32_t end = count;
+    if (dmax_arr && idx < count) {
+        end = (idx / _SAROS_DMAX_BLOCK + 1u) * _SAROS_DMAX_BLOCK;
+        if (end > count)
+            end = count;
+    }
+    for (;;) {
+        for (; idx < end; idx++)
+            if (_saros_duration_at(info_arr, idx, is_lunar, field) >= key)
+                return idx;
+        if (end >= count)
+            return count;
+        uint32_t b = _dmax_first(dmax_arr + field * leaves * 4u, leaves,
+                                 end / _SAROS_DMAX_BLOCK, key);
+        if (b == UINT32_MAX)
+            return count;
+        idx = b * _SAROS_DMAX_BLOCK;
+        end = idx + _SAROS_DMAX_BLOCK;
+        if (end > count)
+            end = count;
+    }
+}
+
+/* Last index before idx whose duration field is known and >= secs, or UINT32_MAX. */
+static uint32_t _saros_past_min_duration(const uint8_t *info_arr,
+                                         const uint8_t *dmax_arr, uint32_t leaves,
+                                         uint32_t idx,
+                                         int is_lunar, uint32_t field, uint16_t secs)
+{
+    uint32_t key   = (uint32_t)secs + 1u;
+    uint32_t begin = 0u;
+    if (dmax_arr && idx > 0u)
+        begin = (idx - 1u) / _SAROS_DMAX_BLOCK * _SAROS_DMAX_BLOCK;
+    for (;;) {
+        while (idx > begin)
+            if (_saros_duration_at(info_arr, --idx, is_lunar, field) >= key)
+                return idx;
+        if (begin == 0u)
+            return UINT32_MAX;
+        uint32_t b = _dmax_last(dmax_arr + field * leaves * 4u, leaves,
+                                begin / _SAROS_DMAX_BLOCK - 1u, key);
+        if (b == UINT32_MAX)
+            return UINT32_MAX;
+        begin = b * _SAROS_DMAX_BLOCK;
+        idx   = begin + _SAROS_DMAX_BLOCK;
+    }
+}
+
+/* ── Spatial filter (solar records only carry coordinates) ──────────────── */
+#if (defined(SAROS_IMPL_SOLAR) && defined(SAROS_USE_GEO_INDEX)) || \
+    defined(SAROS_IMPL_DB) || defined(SAROS_IMPL_CTX)
+
+#include <math.h>     /* sin, cos, asin, sqrt, floor, fmod, isfinite */
+
+#define _SAROS_RAD_PER_DEG10  (3.14159265358979323846 / 1800.0)
+
+/* Query circle, with the trig of its centre computed once. */
+typedef struct {
+    double lat, lon;           /* centre, radians */
+    double cos_lat;
+    double hav_max;            /* haversine of the radius; 2 admits every point */
+} _saros_circle_t;
+
+static void _circle_init(_saros_circle_t *c, double lat_deg, double lon_deg,
+                         double radius_km)
+{
+    double d = radius_km / SAROS_EARTH_RADIUS_KM;
+    double h = sin(d * 0.5);
+    c->lat     = lat_deg * (_SAROS_RAD_PER_DEG10 * 10.0);
+    c->lon     = lon_deg * (_SAROS_RAD_PER_DEG10 * 10.0);
+    c->cos_lat = cos(c->lat);
+    c->hav_max = (d >= 3.14159265358979323846) ? 2.0 : h * h;
+}
+
+/* Distance in km from the centre to a point given in tenths of a degree,
+ * or -1 if the point lies outside the circle. */
+static double _circle_distance(const _saros_circle_t *c, int16_t lat10, int16_t lon10)
+{
+    double lat = lat10 * _SAROS_RAD_PER_DEG10;
+    double sl  = sin((lat - c->lat) * 0.5);
+    double so  = sin((lon10 * _SAROS_RAD_PER_DEG10 - c->lon) * 0.5);
+    double h   = sl * sl + c->cos_lat * cos(lat) * so * so;
+    if (h > c->hav_max)
+        return -1.0;
+    return 2.0 * SAROS_EARTH_RADIUS_KM * asin(sqrt(h < 1.0 ? h : 1.0));
+}
+
+/* Tests eclipse idx; returns nonzero once cb asks to stop. */
+static int _near_visit(const uint8_t *info_arr, const _saros_circle_t *c,
+                       uint32_t idx, solar_near_fn cb, void *user, uint32_t *calls)
+{
+    solar_eclipse_info_t si = _saros_solar_info_at(info_arr, idx);
+    double km = _circle_distance(c, si.latitude_deg10, si.longitude_deg10);
+    if (km < 0.0)
+        return 0;
+    (*calls)++;
+    return cb(idx, km, user);
+}
+
+/*
+ * Reports the eclipses in [i0, i1) within radius_km of (lat_deg, lon_deg).
+ * Without a grid (geo_offsets == NULL) every one is tested.  With one, only
+ * the cells of the circle's bounding box are read: rows over lat +- d, and
+ * columns over lon +- asin(sin d / cos lat) unless the circle reaches a
+ * pole, each widened by a tenth of a degree against rounding.  A cell's
+ * members are in index order, so [i0, i1) is a binary search and a prefix.
+ * A point off the globe finds nothing; lon is first brought into [-180, 180)
+ * so the column casts below stay in range.
+ */
+static uint32_t _saros_near(const uint8_t *info_arr, const uint8_t *geo_offsets,
+                            const uint8_t *geo_members, uint32_t cell,
+                            uint32_t i0, uint32_t i1,
+                            double lat_deg, double lon_deg, double radius_km,
+                            solar_near_fn cb, void *user)
+{
+    uint32_t calls = 0;
+    if (i0 >= i1 || !(radius_km >= 0.0) ||
+        !(lat_deg >= -90.0 && lat_deg <= 90.0) || !isfinite(lon_deg))
+        return 0;
+    lon_deg = fmod(lon_deg, 360.0);
+    if (lon_deg >= 180.0)
+        lon_deg -= 360.0;
+    else if (lon_deg < -180.0)
+        lon_deg += 360.0;
+    _saros_circle_t c;
+    _circle_init(&c, lat_deg, lon_deg, radius_km);
+
+    if (!geo_offsets) {
+        for (uint32_t idx = i0; idx < i1; idx++)
+            if (_near_visit(info_arr, &c, idx, cb, user, &calls))
+                break;
+        return calls;
+    }
+
+    uint32_t rows = 1800u / cell, cols = 3600u / cell;
+    double   d    = radius_km / SAROS_EARTH_RADIUS_KM;
+    double   dlat = d / _SAROS_RAD_PER_DEG10 + 1.0;
+    double   lo   = lat_deg * 10.0 + 900.0 - dlat;
+    double   hi   = lat_deg * 10.0 + 900.0 + dlat;
+    if (hi < 0.0 || lo > 1800.0)
+        return 0;
+    uint32_t r0   = (lo <= 0.0)    ? 0u        : (uint32_t)(lo / cell);
+    uint32_t r1   = (hi >= 1800.0) ? rows - 1u : (uint32_t)(hi / cell);
+    if (r0 >= rows)
+        r0 = rows - 1u;
+    int32_t  c0   = 0;
+    uint32_t ncol = cols;
+    if (lo > 0.0 && hi < 1800.0) {
+        double s = sin(d) / c.cos_lat;
+        if (s < 1.0) {
+            double dlon = asin(s) / _SAROS_RAD_PER_DEG10 + 1.0;
+            double west = lon_deg * 10.0 + 1800.0 - dlon;
+            double east = lon_deg * 10.0 + 1800.0 + dlon;
+            c0 = (int32_t)floor(west / cell);
+            int32_t c1 = (int32_t)floor(east / cell);
+            if ((uint32_t)(c1 - c0) < cols)
+                ncol = (uint32_t)(c1 - c0) + 1u;
+        }
+    }
+
+    for (uint32_t r = r0; r <= r1; r++) {
+        for (uint32_t k = 0; k < ncol; k++) {
+            int32_t  col  = (c0 + (int32_t)k) % (int32_t)cols;
+            uint32_t cidx = r * cols + (uint32_t)(col < 0 ? col + (int32_t)cols : col);
+            uint32_t lo_m = _saros_member(geo_offsets, cidx);
+            uint32_t end  = _saros_member(geo_offsets, cidx + 1u);
+            uint32_t hi_m = end;
+            while (lo_m < hi_m) {
+                uint32_t mid = lo_m + (hi_m - lo_m) / 2u;
+                if (_saros_member(geo_members, mid) < i0)
+                    lo_m = mid + 1u;
+                else
+                    hi_m = mid;
+            }
+            for (; lo_m < end; lo_m++) {
+                uint32_t idx = _saros_member(geo_members, lo_m);
+                if (idx >= i1)
+                    break;
+                if (_near_visit(info_arr, &c, idx, cb, user, &calls))
+                    return calls;
+            }
+        }
+    }
+    return calls;
+}
+
+#endif /* (SAROS_IMPL_SOLAR && SAROS_USE_GEO_INDEX) || SAROS_IMPL_DB || SAROS_IMPL_CTX */
+
+/* ── Context handles ────────────────────────────────────────────────────── *
+ * Everything after the search, over one saros_ctx_t.  The SOLAR and LUNAR
+ * sections pass _solar_ctx / _lunar_ctx, built from the bindings, after
+ * their own search (_SAROS_LOWER_BOUND: Eytzinger, buckets, packed); the
+ * saros_find_*() calls pass the caller's ctx, and the saros_db_*() calls
+ * the one saros_db_open() built per kind, after the plain binary search.
+ */
+
+static inline int _saros_ctx_lunar(const saros_ctx_t *c)
+{
+    return c->kind == ECLIPSE_KIND_LUNAR;
+}
+
+static inline uint32_t _saros_ctx_lower(const saros_ctx_t *c, int64_t key)
+{
+    return _lower_bound_in(c->times, c->count, 0u, c->count, key);
+}
+
+static inline uint32_t _saros_ctx_upper(const saros_ctx_t *c, int64_t key)
+{
+    return _upper_bound_in(c->times, c->count, 0u, c->count, key);
+}
+
+/* Result for focal_idx, in the shape _saros_batch() calls. */
+static eclipse_result_t _saros_ctx_build(const void *ctx, uint32_t focal_idx)
+{
+    const saros_ctx_t *c = (const saros_ctx_t *)ctx;
+    int lunar = _saros_ctx_lunar(c);
+    eclipse_result_t r;
+    memset(&r, 0, sizeof(r));
+    r.eclipse = _make_entry(c->times, c->info, focal_idx, lunar);
+    _saros_neighbours(c->times, c->info, c->prev_in_series, c->next_in_series,
+                      focal_idx, lunar, &r.saros_prev, &r.saros_next);
+    return r;
+}
+
+/* Result for idx, or an empty one for idx >= count (UINT32_MAX included). */
+static eclipse_result_t _saros_ctx_result(const saros_ctx_t *c, uint32_t idx)
+{
+    eclipse_result_t r;
+    if (idx >= c->count)
+        memset(&r, 0, sizeof(r));
+    else
+        r = _saros_ctx_build(c, idx);
+    return r;
+}
+
+/* Type filter over [idx, end), through the class bitmaps when ctx has them. */
+static uint32_t _saros_ctx_next_of(const saros_ctx_t *c, uint32_t idx, uint32_t end,
+                                   uint32_t type_mask)
+{
+    int lunar = _saros_ctx_lunar(c), exact = 0;
+    uint32_t set = 0;
+    if (c->class_bitmaps)
+        set = _class_set(_saros_class_types[lunar], _saros_classes[lunar], type_mask, &exact);
+    return _saros_next_of(c->info, c->class_bitmaps, set, exact, c->count,
+                          idx, end, type_mask, lunar);
+}
+
+static uint32_t _saros_ctx_past_of(const saros_ctx_t *c, uint32_t idx, uint32_t type_mask)
+{
+    int lunar = _saros_ctx_lunar(c), exact = 0;
+    uint32_t set = 0;
+    if (c->class_bitmaps)
+        set = _class_set(_saros_class_types[lunar], _saros_classes[lunar], type_mask, &exact);
+    return _saros_past_of(c->info, c->class_bitmaps, set, exact, c->count,
+                          idx, type_mask, lunar);
+}
+
+/* Duration filter from idx; solar records only have the central duration. */
+static uint32_t _saros_ctx_next_min(const saros_ctx_t *c, uint32_t idx,
+                                    lunar_phase_t phase, uint16_t secs)
+{
+    int lunar = _saros_ctx_lunar(c);
+    return _saros_next_min_duration(c->info, c->dmax, c->dmax_leaves, c->count, idx,
+                                    lunar, lunar ? (uint32_t)phase : 0u, secs);
+}
+
+static uint32_t _saros_ctx_past_min(const saros_ctx_t *c, uint32_t idx,
+                                    lunar_phase_t phase, uint16_t secs)
+{
+    int lunar = _saros_ctx_lunar(c);
+    return _saros_past_min_duration(c->info, c->dmax, c->dmax_leaves, idx,
+                                    lunar, lunar ? (uint32_t)phase : 0u, secs);
+}
+
+/* Last eclipse of the series before timestamp and first one at or after it,
+ * by a binary search over the series' members. */
+static saros_window_t _saros_ctx_window(const saros_ctx_t *c, int64_t timestamp,
+                                        uint8_t saros_number)
+{
+    int lunar = _saros_ctx_lunar(c);
+    saros_window_t w;
+    memset(&w, 0, sizeof(w));
+    w.saros_number = saros_number;
+
+    if (c->count == 0u || saros_number < c->saros_first || saros_number > c->saros_last)
+        return w;
+
+    uint32_t begin, end;
+    _saros_series(c->saros_offsets, saros_number, c->saros_first, &begin, &end);
+
+    uint32_t lo = begin, hi = end;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2u;
+        if (_saros_read_time(c->times, _saros_member(c->saros_members, mid)) < timestamp)
+            lo = mid + 1u;
+        else
+            hi = mid;
+    }
+    if (lo < end)
+        w.future = _make_entry(c->times, c->info, _saros_member(c->saros_members, lo), lunar);
+    if (lo > begin)
+        w.past   = _make_entry(c->times, c->info, _saros_member(c->saros_members, lo - 1u),
+                               lunar);
+    return w;
+}
+
+static inline int _saros_ctx_range_next_of(const saros_ctx_t *c, eclipse_range_t *range,
+                                           uint32_t type_mask)
+{
+    /* one call per kind, so each gets a scan specialized for its records */
+    if (_saros_ctx_lunar(c))
+        return _saros_range_next_of(range, c->info, c->class_bitmaps, c->count,
+                                    type_mask, /*lunar=*/1);
+    return _saros_range_next_of(range, c->info, c->class_bitmaps, c->count,
+                                type_mask, /*lunar=*/0);
+}
+
+/* ────────────────────────────────────────────────────────────────────────── *
+ * SOLAR implementation                                                       *
+ * ────────────────────────────────────────────────────────────────────────── */
+#if defined(SAROS_IMPL_SOLAR)
+#define _SAROS_KIND     solar
+#define _SAROS_KIND_UC  SOLAR
+
+/* This unit's solar data; searches stay with _SAROS_LOWER_BOUND.  Under
+ * SAROS_SHARE_CTX it is exported as saros_ctx_solar_<slice> for ctx_impl.c
+ * to leave out. */
+#ifdef SAROS_SHARE_CTX
+#  define _solar_ctx  _SAROS_CTX_SYM
+#endif
+_SAROS_CTX_LINKAGE const saros_ctx_t _solar_ctx = {
+    ECLIPSE_KIND_SOLAR, _SAROS_COUNT, _SAROS_FIRST, _SAROS_LAST,
+    _SAROS_TIMES_ARR, _SAROS_INFO_ARR, _SAROS_OFFSETS_ARR, _SAROS_MEMBERS_ARR,
+    _SAROS_PREV_ARR, _SAROS_NEXT_ARR, _SAROS_CLASS_ARR, _SAROS_DMAX_ARR, _SAROS_DMAX_LEAVES,
+    _SAROS_GEO_OFFSETS_ARR, _SAROS_GEO_MEMBERS_ARR, _SAROS_GEO_CELL,
+};
+
+static SAROS_THREAD_LOCAL _saros_cache_t _solar_cache;
+static volatile uint32_t _solar_cache_gen;
+
+void solar_invalidate_cache(void)
+{
+    _SAROS_GEN_BUMP(_solar_cache_gen);
+}
+
+eclipse_result_t find_next_solar_eclipse(int64_t timestamp)
+{
+    uint32_t gen = _SAROS_GEN_LOAD(_solar_cache_gen);
+    if (_saros_cache_hit(&_solar_cache, _SAROS_CACHE_NEXT, gen, timestamp))
+        return _solar_cache.result;
+
+    uint32_t idx = _SAROS_LOWER_BOUND(timestamp);
+    eclipse_result_t r = _saros_ctx_result(&_solar_ctx, idx);
+    _saros_cache_fill(&_solar_cache, _SAROS_CACHE_NEXT, gen,
+                      _SAROS_TIMES_ARR, _SAROS_COUNT, idx, &r);
+    return r;
+}
+
+eclipse_result_t find_past_solar_eclipse(int64_t timestamp)
+{
+    uint32_t gen = _SAROS_GEN_LOAD(_solar_cache_gen);
+    if (_saros_cache_hit(&_solar_cache, _SAROS_CACHE_PAST, gen, timestamp))
+        return _solar_cache.result;
+
+    uint32_t idx = _SAROS_UPPER_BOUND(timestamp);
+    eclipse_result_t r = _saros_ctx_result(&_solar_ctx, idx - 1u);
+    _saros_cache_fill(&_solar_cache, _SAROS_CACHE_PAST, gen,
+                      _SAROS_TIMES_ARR, _SAROS_COUNT, idx, &r);
+    return r;
+}
+
+eclipse_result_t find_closest_solar_eclipse(int64_t timestamp)
+{
+    uint32_t gen = _SAROS_GEN_LOAD(_solar_cache_gen);
+    if (_saros_cache_hit(&_solar_cache, _SAROS_CACHE_CLOSEST, gen, timestamp))
+        return _solar_cache.result;
+
+    uint32_t idx = _saros_closest(_SAROS_TIMES_ARR, _SAROS_COUNT,
+                                  _SAROS_LOWER_BOUND(timestamp), timestamp);
+    eclipse_result_t r = _saros_ctx_result(&_solar_ctx, idx);
+    _saros_cache_fill(&_solar_cache, _SAROS_CACHE_CLOSEST, gen,
+                      _SAROS_TIMES_ARR, _SAROS_COUNT, idx == UINT32_MAX ? 0u : idx, &r);
+    return r;
+}
+
+eclipse_result_t find_next_solar_eclipse_of(int64_t timestamp, uint32_t type_mask)
+{
+    return _saros_ctx_result(&_solar_ctx,
+                             _saros_ctx_next_of(&_solar_ctx, _SAROS_LOWER_BOUND(timestamp),
+                                                _SAROS_COUNT, type_mask));
+}
+
+eclipse_result_t find_past_solar_eclipse_of(int64_t timestamp, uint32_t type_mask)
+{
+    return _saros_ctx_result(&_solar_ctx,
+                             _saros_ctx_past_of(&_solar_ctx, _SAROS_UPPER_BOUND(timestamp),
+                                                type_mask));
+}
+
+eclipse_result_t find_next_solar_eclipse_min_duration(int64_t timestamp, uint16_t secs)
+{
+    return _saros_ctx_result(&_solar_ctx,
+                             _saros_ctx_next_min(&_solar_ctx, _SAROS_LOWER_BOUND(timestamp),
+                                                 LUNAR_PHASE_PENUMBRAL /* unused */, secs));
+}
+
+eclipse_result_t find_past_solar_eclipse_min_duration(int64_t timestamp, uint16_t secs)
+{
+    return _saros_ctx_result(&_solar_ctx,
+                             _saros_ctx_past_min(&_solar_ctx, _SAROS_UPPER_BOUND(timestamp),
+                                                 LUNAR_PHASE_PENUMBRAL /* unused */, secs));
+}
+
+void find_next_solar_eclipse_batch(const int64_t *timestamps, size_t n,
+                                   eclipse_result_t *out)
+{
+    _saros_batch(_SAROS_TIMES_ARR, _SAROS_COUNT, timestamps, n, _SAROS_CACHE_NEXT,
+                 _saros_ctx_build, &_solar_ctx, out);
+}
+
+void find_past_solar_eclipse_batch(const int64_t *timestamps, size_t n,
+                                   eclipse_result_t *out)
+{
+    _saros_batch(_SAROS_TIMES_ARR, _SAROS_COUNT, timestamps, n, _SAROS_CACHE_PAST,
+                 _saros_ctx_build, &_solar_ctx, out);
+}
+
+uint32_t find_next_solar_index(int64_t timestamp)
+{
+    uint32_t idx = _SAROS_LOWER_BOUND(timestamp);
+    return (idx < _SAROS_COUNT) ? idx : SAROS_NO_ECLIPSE;
+}
+
+uint32_t find_past_solar_index(int64_t timestamp)
+{
+    uint32_t idx = _SAROS_UPPER_BOUND(timestamp);
+    return (idx > 0u) ? idx - 1u : SAROS_NO_ECLIPSE;
+}
+
+uint32_t find_closest_solar_index(int64_t timestamp)
+{
+    return _saros_closest(_SAROS_TIMES_ARR, _SAROS_COUNT,
+                          _SAROS_LOWER_BOUND(timestamp), timestamp);
+}
+
+int64_t saros_solar_time(uint32_t idx)
+{
+    return _saros_read_time(_SAROS_TIMES_ARR, idx);
+}
+
+solar_eclipse_type_t saros_solar_type(uint32_t idx)
+{
+    return (solar_eclipse_type_t)_saros_type_at(_SAROS_INFO_ARR, idx, /*lunar=*/0);
+}
+
+solar_eclipse_info_t saros_solar_info(uint32_t idx)
+{
+    return _saros_solar_info_at(_SAROS_INFO_ARR, idx);
+}
+
+void saros_solar_neighbours(uint32_t idx, uint32_t *prev, uint32_t *next)
+{
+    *prev = _saros_link(_SAROS_PREV_ARR, idx);
+    *next = _saros_link(_SAROS_NEXT_ARR, idx);
+}
+
+eclipse_result_t saros_solar_result(uint32_t idx)
+{
+    return _saros_ctx_build(&_solar_ctx, idx);
+}
+
+eclipse_range_t solar_eclipse_range(int64_t t0, int64_t t1)
+{
+    if (t1 <= t0)
+        return _saros_range(0u, 0u);
+    return _saros_range(_SAROS_LOWER_BOUND(t0), _SAROS_LOWER_BOUND(t1));
+}
+
+int solar_range_next(eclipse_range_t *range)
+{
+    return _saros_range_next(range);
+}
+
+int64_t solar_range_time(const eclipse_range_t *range)
+{
+    return saros_solar_time(range->index);
+}
+
+solar_eclipse_info_t solar_range_info(const eclipse_range_t *range)
+{
+    return saros_solar_info(range->index);
+}
+
+eclipse_entry_t solar_range_entry(const eclipse_range_t *range)
+{
+    return _make_entry(_SAROS_TIMES_ARR, _SAROS_INFO_ARR, range->index, /*lunar=*/0);
+}
+
+int solar_range_next_of(eclipse_range_t *range, uint32_t type_mask)
+{
+    return _saros_range_next_of(range, _SAROS_INFO_ARR, _SAROS_CLASS_ARR, _SAROS_COUNT,
+                                type_mask, /*lunar=*/0);
+}
+
+#ifdef SAROS_USE_GEO_INDEX
+uint32_t find_solar_eclipses_near(double lat, double lon, double radius_km,
+                                  int64_t t0, int64_t t1,
+                                  solar_near_fn cb, void *user)
+{
+    if (t1 <= t0)
+        return 0;
+    return _saros_near(_SAROS_INFO_ARR, _SAROS_GEO_OFFSETS_ARR, _SAROS_GEO_MEMBERS_ARR,
+                       _SAROS_GEO_CELL, _SAROS_LOWER_BOUND(t0), _SAROS_LOWER_BOUND(t1),
+                       lat, lon, radius_km, cb, user);
+}
+#endif
+
+saros_window_t find_solar_saros_window(int64_t timestamp, uint8_t saros_number)
+{
+    return _saros_ctx_window(&_solar_ctx, timestamp, saros_number);
+}
+
+#undef _solar_ctx
+#undef _SAROS_KIND
+#undef _SAROS_KIND_UC
+#endif /* SAROS_IMPL_SOLAR */
+
+/* ────────────────────────────────────────────────────────────────────────── *
+ * LUNAR implementation                                                       *
+ * ────────────────────────────────────────────────────────────────────────── */
+#if defined(SAROS_IMPL_LUNAR)
+#define _SAROS_KIND     lunar
+#define _SAROS_KIND_UC  LUNAR
+
+/* This unit's lunar data; searches stay with _SAROS_LOWER_BOUND.  Under
+ * SAROS_SHARE_CTX it is exported as saros_ctx_lunar_<slice> for ctx_impl.c
+ * to leave out. */
+#ifdef SAROS_SHARE_CTX
+#  define _lunar_ctx  _SAROS_CTX_SYM
+#endif
+_SAROS_CTX_LINKAGE const saros_ctx_t _lunar_ctx = {
+    ECLIPSE_KIND_LUNAR, _SAROS_COUNT, _SAROS_FIRST, _SAROS_LAST,
+    _SAROS_TIMES_ARR, _SAROS_INFO_ARR, _SAROS_OFFSETS_ARR, _SAROS_MEMBERS_ARR,
+    _SAROS_PREV_ARR, _SAROS_NEXT_ARR, _SAROS_CLASS_ARR, _SAROS_DMAX_ARR, _SAROS_DMAX_LEAVES,
+    0, 0, 0u,
+};
+
+static SAROS_THREAD_LOCAL _saros_cache_t _lunar_cache;
+static volatile uint32_t _lunar_cache_gen;
+
+void lunar_invalidate_cache(void)
+{
+    _SAROS_GEN_BUMP(_lunar_cache_gen);
+}
+
+eclipse_result_t find_next_lunar_eclipse(int64_t timestamp)
+{
+    uint32_t gen = _SAROS_GEN_LOAD(_lunar_cache_gen);
+    if (_saros_cache_hit(&_lunar_cache, _SAROS_CACHE_NEXT, gen, timestamp))
+        return _lunar_cache.result;
+
+    uint32_t idx = _SAROS_LOWER_BOUND(timestamp);
+    eclipse_result_t r = _saros_ctx_result(&_lunar_ctx, idx);
+    _saros_cache_fill(&_lunar_cache, _SAROS_CACHE_NEXT, gen,
+                      _SAROS_TIMES_ARR, _SAROS_COUNT, idx, &r);
+    return r;
+}
+
+eclipse_result_t find_past_lunar_eclipse(int64_t timestamp)
+{
+    uint32_t gen = _SAROS_GEN_LOAD(_lunar_cache_gen);
+    if (_saros_cache_hit(&_lunar_cache, _SAROS_CACHE_PAST, gen, timestamp))
+        return _lunar_cache.result;
+
+    uint32_t idx = _SAROS_UPPER_BOUND(timestamp);
+    eclipse_result_t r = _saros_ctx_result(&_lunar_ctx, idx - 1u);
+    _saros_cache_fill(&_lunar_cache, _SAROS_CACHE_PAST, gen,
+                      _SAROS_TIMES_ARR, _SAROS_COUNT, idx, &r);
+    return r;
+}
+
+eclipse_result_t find_closest_lunar_eclipse(int64_t timestamp)
+{
+    uint32_t gen = _SAROS_GEN_LOAD(_lunar_cache_gen);
+    if (_saros_cache_hit(&_lunar_cache, _SAROS_CACHE_CLOSEST, gen, timestamp))
+        return _lunar_cache.result;
+
+    uint32_t idx = _saros_closest(_SAROS_TIMES_ARR, _SAROS_COUNT,
+                                  _SAROS_LOWER_BOUND(timestamp), timestamp);
+    eclipse_result_t r = _saros_ctx_result(&_lunar_ctx, idx);
+    _saros_cache_fill(&_lunar_cache, _SAROS_CACHE_CLOSEST, gen,
+                      _SAROS_TIMES_ARR, _SAROS_COUNT, idx == UINT32_MAX ? 0u : idx, &r);
+    return r;
+}
+
+eclipse_result_t find_next_lunar_eclipse_of(int64_t timestamp, uint32_t type_mask)
+{
+    return _saros_ctx_result(&_lunar_ctx,
+                             _saros_ctx_next_of(&_lunar_ctx, _SAROS_LOWER_BOUND(timestamp),
+                                                _SAROS_COUNT, type_mask));
+}
+
+eclipse_result_t find_past_lunar_eclipse_of(int64_t timestamp, uint32_t type_mask)
+{
+    return _saros_ctx_result(&_lunar_ctx,
+                             _saros_ctx_past_of(&_lunar_ctx, _SAROS_UPPER_BOUND(timestamp),
+                                                type_mask));
+}
+
+eclipse_result_t find_next_lunar_eclipse_min_duration(int64_t timestamp, lunar_phase_t phase,
+                                                      uint16_t secs)
+{
+    return _saros_ctx_result(&_lunar_ctx,
+                             _saros_ctx_next_min(&_lunar_ctx, _SAROS_LOWER_BOUND(timestamp),
+                                                 phase, secs));
+}
+
+eclipse_result_t find_past_lunar_eclipse_min_duration(int64_t timestamp, lunar_phase_t phase,
+                                                      uint16_t secs)
+{
+    return _saros_ctx_result(&_lunar_ctx,
+                             _saros_ctx_past_min(&_lunar_ctx, _SAROS_UPPER_BOUND(timestamp),
+                                                 phase, secs));
+}
+
+void find_next_lunar_eclipse_batch(const int64_t *timestamps, size_t n,
+                                   eclipse_result_t *out)
+{
+    _saros_batch(_SAROS_TIMES_ARR, _SAROS_COUNT, timestamps, n, _SAROS_CACHE_NEXT,
+                 _saros_ctx_build, &_lunar_ctx, out);
+}
+
+void find_past_lunar_eclipse_batch(const int64_t *timestamps, size_t n,
+                                   eclipse_result_t *out)
+{
+    _saros_batch(_SAROS_TIMES_ARR, _SAROS_COUNT, timestamps, n, _SAROS_CACHE_PAST,
+                 _saros_ctx_build, &_lunar_ctx, out);
+}
+
+uint32_t find_next_lunar_index(int64_t timestamp)
+{
+    uint32_t idx = _SAROS_LOWER_BOUND(timestamp);
+    return (idx < _SAROS_COUNT) ? idx : SAROS_NO_ECLIPSE;
+}
+
+uint32_t find_past_lunar_index(int64_t timestamp)
+{
+    uint32_t idx = _SAROS_UPPER_BOUND(timestamp);
+    return (idx > 0u) ? idx - 1u : SAROS_NO_ECLIPSE;
+}
+
+uint32_t find_closest_lunar_index(int64_t timestamp)
+{
+    return _saros_closest(_SAROS_TIMES_ARR, _SAROS_COUNT,
+                          _SAROS_LOWER_BOUND(timestamp), timestamp);
+}
+
+int64_t saros_lunar_time(uint32_t idx)
+{
+    return _saros_read_time(_SAROS_TIMES_ARR, idx);
+}
+
+lunar_eclipse_type_t saros_lunar_type(uint32_t idx)
+{
+    return (lunar_eclipse_type_t)_saros_type_at(_SAROS_INFO_ARR, idx, /*lunar=*/1);
+}
+
+lunar_eclipse_info_t saros_lunar_info(uint32_t idx)
+{
+    return _saros_lunar_info_at(_SAROS_INFO_ARR, idx);
+}
+
+void saros_lunar_neighbours(uint32_t idx, uint32_t *prev, uint32_t *next)
+{
+    *prev = _saros_link(_SAROS_PREV_ARR, idx);
+    *next = _saros_link(_SAROS_NEXT_ARR, idx);
+}
+
+eclipse_result_t saros_lunar_result(uint32_t idx)
+{
+    return _saros_ctx_build(&_lunar_ctx, idx);
+}
+
+eclipse_range_t lunar_eclipse_range(int64_t t0, int64_t t1)
+{
+    if (t1 <= t0)
+        return _saros_range(0u, 0u);
+    return _saros_range(_SAROS_LOWER_BOUND(t0), _SAROS_LOWER_BOUND(t1));
+}
+
+int lunar_range_next(eclipse_range_t *range)
+{
+    return _saros_range_next(range);
+}
+
+int64_t lunar_range_time(const eclipse_range_t *range)
+{
+    return saros_lunar_time(range->index);
+}
+
+lunar_eclipse_info_t lunar_range_info(const eclipse_range_t *range)
+{
+    return saros_lunar_info(range->index);
+}
+
+eclipse_entry_t lunar_range_entry(const eclipse_range_t *range)
+{
+    return _make_entry(_SAROS_TIMES_ARR, _SAROS_INFO_ARR, range->index, /*lunar=*/1);
+}
+
+int lunar_range_next_of(eclipse_range_t *range, uint32_t type_mask)
+{
+    return _saros_range_next_of(range, _SAROS_INFO_ARR, _SAROS_CLASS_ARR, _SAROS_COUNT,
+                                type_mask, /*lunar=*/1);
+}
+
+saros_window_t find_lunar_saros_window(int64_t timestamp, uint8_t saros_number)
+{
+    return _saros_ctx_window(&_lunar_ctx, timestamp, saros_number);
+}
+
+#undef _lunar_ctx
+#undef _SAROS_KIND
+#undef _SAROS_KIND_UC
+#endif /* SAROS_IMPL_LUNAR */
+
+/* ────────────────────────────────────────────────────────────────────────── *
+ * Context handles — the lookups over a caller's saros_ctx_t                  *
+ * ────────────────────────────────────────────────────────────────────────── */
+#if defined(SAROS_IMPL_CTX)
+
+eclipse_result_t saros_find_next(const saros_ctx_t *ctx, int64_t timestamp)
+{
+    return _saros_ctx_result(ctx, _saros_ctx_lower(ctx, timestamp));
+}
+
+eclipse_result_t saros_find_past(const saros_ctx_t *ctx, int64_t timestamp)
+{
+    return _saros_ctx_result(ctx, _saros_ctx_upper(ctx, timestamp) - 1u);
+}
+
+eclipse_result_t saros_find_closest(const saros_ctx_t *ctx, int64_t timestamp)
+{
+    return _saros_ctx_result(ctx, saros_closest_index(ctx, timestamp));
+}
+
+saros_window_t saros_find_window(const saros_ctx_t *ctx, int64_t timestamp,
+                                 uint8_t saros_number)
+{
+    return _saros_ctx_window(ctx, timestamp, saros_number);
+}
+
+eclipse_result_t saros_find_next_of(const saros_ctx_t *ctx, int64_t timestamp,
+                                    uint32_t type_mask)
+{
+    return _saros_ctx_result(ctx, _saros_ctx_next_of(ctx, _saros_ctx_lower(ctx, timestamp),
+                                                     ctx->count, type_mask));
+}
+
+eclipse_result_t saros_find_past_of(const saros_ctx_t *ctx, int64_t timestamp,
+                                    uint32_t type_mask)
+{
+    return _saros_ctx_result(ctx, _saros_ctx_past_of(ctx, _saros_ctx_upper(ctx, timestamp),
+                                                     type_mask));
+}
+
+eclipse_result_t saros_find_next_min_duration(const saros_ctx_t *ctx, int64_t timestamp,
+                                              lunar_phase_t phase, uint16_t secs)
+{
+    return _saros_ctx_result(ctx, _saros_ctx_next_min(ctx, _saros_ctx_lower(ctx, timestamp),
+                                                      phase, secs));
+}
+
+eclipse_result_t saros_find_past_min_duration(const saros_ctx_t *ctx, int64_t timestamp,
+                                              lunar_phase_t phase, uint16_t secs)
+{
+    return _saros_ctx_result(ctx, _saros_ctx_past_min(ctx, _saros_ctx_upper(ctx, timestamp),
+                                                      phase, secs));
+}
+
+void saros_find_next_batch(const saros_ctx_t *ctx, const int64_t *timestamps, size_t n,
+                           eclipse_result_t *out)
+{
+    _saros_batch(ctx->times, ctx->count, timestamps, n, _SAROS_CACHE_NEXT,
+                 _saros_ctx_build, ctx, out);
+}
+
+void saros_find_past_batch(const saros_ctx_t *ctx, const int64_t *timestamps, size_t n,
+                           eclipse_result_t *out)
+{
+    _saros_batch(ctx->times, ctx->count, timestamps, n, _SAROS_CACHE_PAST,
+                 _saros_ctx_build, ctx, out);
+}
+
+uint32_t saros_find_near(const saros_ctx_t *ctx,
+                         double lat, double lon, double radius_km,
+                         int64_t t0, int64_t t1,
+                         solar_near_fn cb, void *user)
+{
+    if (_saros_ctx_lunar(ctx) || t1 <= t0)
+        return 0;
+    return _saros_near(ctx->info, ctx->geo_offsets, ctx->geo_members, ctx->geo_cell,
+                       _saros_ctx_lower(ctx, t0), _saros_ctx_lower(ctx, t1),
+                       lat, lon, radius_km, cb, user);
+}
+
+uint32_t saros_next_index(const saros_ctx_t *ctx, int64_t timestamp)
+{
+    uint32_t idx = _saros_ctx_lower(ctx, timestamp);
+    return (idx < ctx->count) ? idx : SAROS_NO_ECLIPSE;
+}
+
+uint32_t saros_past_index(const saros_ctx_t *ctx, int64_t timestamp)
+{
+    uint32_t idx = _saros_ctx_upper(ctx, timestamp);
+    return (idx > 0u) ? idx - 1u : SAROS_NO_ECLIPSE;
+}
+
+uint32_t saros_closest_index(const saros_ctx_t *ctx, int64_t timestamp)
+{
+    return _saros_closest(ctx->times, ctx->count, _saros_ctx_lower(ctx, timestamp), timestamp);
+}
+
+int64_t saros_time(const saros_ctx_t *ctx, uint32_t idx)
+{
+    return _saros_read_time(ctx->times, idx);
+}
+
+uint8_t saros_type(const saros_ctx_t *ctx, uint32_t idx)
+{
+    return _saros_type_at(ctx->info, idx, _saros_ctx_lunar(ctx));
+}
 
-    if (saros_pos > 0u) {
-        *out_prev = _make_entry(times_arr, info_arr, indices[saros_pos - 1u], is_lunar);
-    }
-    if ((uint32_t)saros_pos + 1u < (uint32_t)count) {
-        *out_next = _make_entry(times_arr, info_arr, indices[saros_pos + 1u], is_lunar);
-    }
+eclipse_entry_t saros_entry(const saros_ctx_t *ctx, uint32_t idx)
+{
+    return _make_entry(ctx->times, ctx->info, idx, _saros_ctx_lunar(ctx));
+}
+
+void saros_neighbours(const saros_ctx_t *ctx, uint32_t idx, uint32_t *prev, uint32_t *next)
+{
+    *prev = _saros_link(ctx->prev_in_series, idx);
+    *next = _saros_link(ctx->next_in_series, idx);
+}
+
+eclipse_result_t saros_result(const saros_ctx_t *ctx, uint32_t idx)
+{
+    return _saros_ctx_result(ctx, idx);
+}
+
+eclipse_range_t saros_range(const saros_ctx_t *ctx, int64_t t0, int64_t t1)
+{
+    if (t1 <= t0)
+        return _saros_range(0u, 0u);
+    return _saros_range(_saros_ctx_lower(ctx, t0), _saros_ctx_lower(ctx, t1));
+}
+
+int saros_range_next(eclipse_range_t *range)
+{
+    return _saros_range_next(range);
+}
+
+int saros_range_next_of(const saros_ctx_t *ctx, eclipse_range_t *range, uint32_t type_mask)
+{
+    return _saros_ctx_range_next_of(ctx, range, type_mask);
 }
 
+#endif /* SAROS_IMPL_CTX */
+
 /* ────────────────────────────────────────────────────────────────────────── *
- * SOLAR implementation                                                       *
+ * Runtime datasets — build_db.py's .db files or container, mapped read-only  *
  * ────────────────────────────────────────────────────────────────────────── */
-#if defined(SAROS_IMPL_SOLAR)
+#if defined(SAROS_IMPL_DB)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>      /* sched_yield */
+#include <stdio.h>      /* snprintf */
+#include <stdlib.h>     /* calloc, free */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(_SAROS_SIMD) && defined(__ARM_FEATURE_CRC32)
+#  include <arm_acle.h>
+#endif
+
+/*
+ * Every section holds the same bytes as the matching array of the "all"
+ * headers, so the shared helpers read it in place:
+ *   times / info   eclipse_times_*[] / eclipse_info_*[]
+ *   series         saros_offsets_*[] (series 1-180) + saros_members_*[],
+ *                  prev_in_series_*[] + next_in_series_*[]
+ *   class / dmax   eclipse_class_*[] / eclipse_dmax_*[] (optional)
+ *   geo            eclipse_geo_offsets_*[] + eclipse_geo_members_*[]
+ *                  (optional, solar only)
+ * A directory has the first six as separate .db files; the container
+ * (see build_db.py) has all of them behind a section table.  Section
+ * numbers are the container's section ids minus one.
+ */
+#define _SAROS_DB_TIMES          0u
+#define _SAROS_DB_INFO           1u
+#define _SAROS_DB_SAROS_OFFSETS  2u
+#define _SAROS_DB_SAROS_MEMBERS  3u
+#define _SAROS_DB_PREV           4u
+#define _SAROS_DB_NEXT           5u
+#define _SAROS_DB_CLASS          6u
+#define _SAROS_DB_DMAX           7u
+#define _SAROS_DB_GEO_OFFSETS    8u
+#define _SAROS_DB_GEO_MEMBERS    9u
+#define _SAROS_DB_SECTIONS       10u
+#define _SAROS_DB_FILES          6u       /* sections a directory has */
+#define _SAROS_DB_SERIES         180u
+
+/* Container layout; must match CONTAINER_* in build_db.py */
+#define _SAROS_DB_VERSION      2u
+#define _SAROS_DB_HEADER_SIZE  64u
+#define _SAROS_DB_ENTRY_SIZE   32u
+#define _SAROS_DB_ALIGN        64u
 
-static eclipse_result_t _solar_build(uint32_t focal_idx)
+typedef struct {
+    const uint8_t *sec[_SAROS_DB_SECTIONS];   /* NULL when absent or empty */
+    size_t         len[_SAROS_DB_SECTIONS];   /* sizes in bytes */
+    uint32_t       count;                     /* eclipses */
+    uint32_t       dmax_leaves;               /* leaves per duration tree */
+    uint32_t       geo_cell;                  /* grid cell in 0.1 degrees */
+    uint8_t        saros_first, saros_last;   /* 0, 0 when empty */
+    int            is_lunar;
+} _saros_db_set_t;
+
+struct saros_db {
+    _saros_db_set_t set[2];                   /* indexed by eclipse_kind_t */
+    saros_ctx_t     ctx[2];                   /* the sets, for the lookups */
+    void           *map[_SAROS_DB_FILES * 2u]; /* mappings to release */
+    size_t          map_len[_SAROS_DB_FILES * 2u];
+    uint32_t        maps;
+};
+
+static const char *const _saros_db_names[_SAROS_DB_FILES] = {
+    "eclipse_times.db", "eclipse_info.db", "saros_offsets.db", "saros_members.db",
+    "prev_in_series.db", "next_in_series.db",
+};
+
+static const uint32_t _saros_db_durations[2]  = { 1u, 3u };   /* trees per kind */
+
+/* ── CRC32C ─────────────────────────────────────────────────────────────── *
+ * Castagnoli polynomial, reflected (0x82F63B78), as build_db.py writes it.
+ * The SSE4.2 / ARMv8 CRC instructions do eight bytes a step; elsewhere a
+ * 16-entry table does four bits.
+ */
+static const uint32_t _saros_crc32c_nibble[16] = {
+    0x00000000u, 0x105EC76Fu, 0x20BD8EDEu, 0x30E349B1u,
+    0x417B1DBCu, 0x5125DAD3u, 0x61C69362u, 0x7198540Du,
+    0x82F63B78u, 0x92A8FC17u, 0xA24BB5A6u, 0xB21572C9u,
+    0xC38D26C4u, 0xD3D3E1ABu, 0xE330A81Au, 0xF36E6F75u,
+};
+
+static uint32_t _saros_crc32c_sw(uint32_t crc, const uint8_t *p, size_t n)
 {
-    eclipse_result_t r;
-    memset(&r, 0, sizeof(r));
-    r.eclipse = _make_entry(_SAROS_TIMES_ARR, _SAROS_INFO_ARR, focal_idx, /*lunar=*/0);
-    _saros_neighbours(
-        _SAROS_TIMES_ARR, _SAROS_INFO_ARR, _SAROS_SAROS_ARR,
-        _SAROS_FIRST, _SAROS_LAST,
-        r.eclipse.info.solar.saros_number,
-        r.eclipse.info.solar.saros_pos,
-        /*lunar=*/0,
-        &r.saros_prev, &r.saros_next);
-    return r;
+    while (n--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ _saros_crc32c_nibble[crc & 15u];
+        crc = (crc >> 4) ^ _saros_crc32c_nibble[crc & 15u];
+    }
+    return crc;
 }
 
-eclipse_result_t find_next_solar_eclipse(int64_t timestamp)
+#if defined(_SAROS_SIMD) && defined(__x86_64__)
+__attribute__((target("sse4.2")))
+static uint32_t _saros_crc32c_hw(uint32_t crc, const uint8_t *p, size_t n)
 {
-    eclipse_result_t empty;
-    memset(&empty, 0, sizeof(empty));
-    uint32_t idx = _lower_bound(_SAROS_TIMES_ARR, _SAROS_COUNT, timestamp);
-    if (idx >= _SAROS_COUNT)
-        return empty;
-    return _solar_build(idx);
+    uint64_t c = crc;
+    for (; n >= 8u; n -= 8u, p += 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+    }
+    crc = (uint32_t)c;
+    for (; n > 0u; n--)
+        crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+#elif defined(_SAROS_SIMD) && defined(__ARM_FEATURE_CRC32)
+static uint32_t _saros_crc32c_hw(uint32_t crc, const uint8_t *p, size_t n)
+{
+    for (; n >= 8u; n -= 8u, p += 8) {
+        uint64_t v;
+        memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+    }
+    for (; n > 0u; n--)
+        crc = __crc32cb(crc, *p++);
+    return crc;
 }
+#endif
 
-eclipse_result_t find_past_solar_eclipse(int64_t timestamp)
+static uint32_t _saros_crc32c(uint32_t crc, const uint8_t *p, size_t n)
 {
-    eclipse_result_t empty;
-    memset(&empty, 0, sizeof(empty));
-    uint32_t idx = _upper_bound(_SAROS_TIMES_ARR, _SAROS_COUNT, timestamp);
-    if (idx == 0u)
-        return empty;
-    return _solar_build(idx - 1u);
+    crc = ~crc;
+#if defined(_SAROS_SIMD) && defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2"))
+        return ~_saros_crc32c_hw(crc, p, n);
+#elif defined(_SAROS_SIMD) && defined(__ARM_FEATURE_CRC32)
+    return ~_saros_crc32c_hw(crc, p, n);
+#endif
+    return ~_saros_crc32c_sw(crc, p, n);
 }
 
-saros_window_t find_solar_saros_window(int64_t timestamp, uint8_t saros_number)
+/* ── Mapping ────────────────────────────────────────────────────────────── */
+
+/* Map one file read-only; an empty file gives NULL.  0 with errno on failure. */
+static int _saros_db_map(const char *path, const uint8_t **out, size_t *len)
 {
-    saros_window_t w;
-    memset(&w, 0, sizeof(w));
-    w.saros_number = saros_number;
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    if (fstat(fd, &st) != 0) {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return 0;
+    }
+    *out = NULL;
+    *len = (size_t)st.st_size;
+    if (*len > 0u) {
+        void *p = mmap(NULL, *len, PROT_READ, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) {
+            int err = errno;
+            close(fd);
+            errno = err;
+            return 0;
+        }
+        *out = (const uint8_t *)p;
+    }
+    close(fd);
+    return 1;
+}
 
-    if (saros_number < _SAROS_FIRST || saros_number > _SAROS_LAST)
-        return w;
+/* Map path and keep the mapping for saros_db_close(). */
+static int _saros_db_keep(saros_db_t *db, const char *path, const uint8_t **out, size_t *len)
+{
+    if (!_saros_db_map(path, out, len))
+        return 0;
+    if (*out) {
+        db->map[db->maps]     = (void *)(uintptr_t)*out;
+        db->map_len[db->maps] = *len;
+        db->maps++;
+    }
+    return 1;
+}
 
-    uint8_t  count = 0;
-    uint16_t indices[SAROS_MAX_ECLIPSES];
-    _saros_load_series(_SAROS_SAROS_ARR, saros_number, _SAROS_FIRST, &count, indices);
+/* ── Validation ─────────────────────────────────────────────────────────── */
 
-    if (count == 0u)
-        return w;
+/* The optional duration trees: whole trees of 'leaves' nodes covering every block. */
+static int _saros_db_valid_dmax(const _saros_db_set_t *s)
+{
+    uint32_t leaves = s->dmax_leaves;
+    if (leaves == 0u || (leaves & (leaves - 1u)) != 0u || leaves > 0x8000u ||
+        (uint64_t)leaves * _SAROS_DMAX_BLOCK < s->count)
+        return 0;
+    return s->len[_SAROS_DB_DMAX] ==
+           (size_t)_saros_db_durations[s->is_lunar] * leaves * 4u;
+}
 
-    /* Binary-search within this series' eclipse list */
-    uint8_t lo = 0, hi = count;
-    while (lo < hi) {
-        uint8_t mid = lo + (hi - lo) / 2u;
-        int64_t t = _saros_read_time(_SAROS_TIMES_ARR, indices[mid]);
-        if (t < timestamp)
-            lo = mid + 1u;
-        else
-            hi = mid;
+/*
+ * The optional grid, offsets and members both: offsets ascend to the end of
+ * the members, which list every eclipse once.
+ */
+static int _saros_db_valid_geo(const _saros_db_set_t *s)
+{
+    uint32_t cell = s->geo_cell;
+    if (s->is_lunar || cell == 0u || 1800u % cell != 0u ||
+        !s->sec[_SAROS_DB_GEO_OFFSETS] || !s->sec[_SAROS_DB_GEO_MEMBERS])
+        return 0;
+    uint32_t cells = (1800u / cell) * (3600u / cell);
+    if (s->len[_SAROS_DB_GEO_OFFSETS] != (size_t)(cells + 1u) * 2u ||
+        s->len[_SAROS_DB_GEO_MEMBERS] != (size_t)s->count * 2u ||
+        _saros_member(s->sec[_SAROS_DB_GEO_OFFSETS], 0u) != 0u ||
+        (size_t)_saros_member(s->sec[_SAROS_DB_GEO_OFFSETS], cells) * 2u !=
+            s->len[_SAROS_DB_GEO_MEMBERS])
+        return 0;
+    for (uint32_t c = 0; c < cells; c++)
+        if (_saros_member(s->sec[_SAROS_DB_GEO_OFFSETS], c) >
+            _saros_member(s->sec[_SAROS_DB_GEO_OFFSETS], c + 1u))
+            return 0;
+    for (uint32_t m = 0; m < s->count; m++)
+        if (_saros_member(s->sec[_SAROS_DB_GEO_MEMBERS], m) >= s->count)
+            return 0;
+    return 1;
+}
+
+/* The links: one per eclipse, each another eclipse or _SAROS_LINK_NONE. */
+static int _saros_db_valid_links(const _saros_db_set_t *s, uint32_t sec)
+{
+    if (s->len[sec] != (size_t)s->count * 2u)
+        return 0;
+    for (uint32_t i = 0; i < s->count; i++) {
+        uint32_t v = _saros_member(s->sec[sec], i);
+        if (v >= s->count && v != _SAROS_LINK_NONE)
+            return 0;
+    }
+    return 1;
+}
+
+/*
+ * Sizes agree with each other, the series offsets ascend to count, every
+ * series lists valid indices in order, and only series inside
+ * [saros_first, saros_last] have members.  Sets count, and the Saros range
+ * when the source did not give one.
+ */
+static int _saros_db_valid(_saros_db_set_t *s, int have_range)
+{
+    if (s->len[_SAROS_DB_TIMES] % 8u != 0u)
+        return 0;
+    size_t n = s->len[_SAROS_DB_TIMES] / 8u;
+    if (n > 0xFFFEu || s->len[_SAROS_DB_INFO] != n * ECLIPSE_INFO_SIZE ||
+        s->len[_SAROS_DB_SAROS_OFFSETS] != (size_t)(_SAROS_DB_SERIES + 1u) * 2u ||
+        s->len[_SAROS_DB_SAROS_MEMBERS] != n * 2u)
+        return 0;
+    s->count = (uint32_t)n;
+    const uint8_t *offsets = s->sec[_SAROS_DB_SAROS_OFFSETS];
+    const uint8_t *members = s->sec[_SAROS_DB_SAROS_MEMBERS];
+    if (_saros_member(offsets, 0u) != 0u || _saros_member(offsets, _SAROS_DB_SERIES) != n)
+        return 0;
+    uint8_t first = 0, last = 0;
+    for (uint32_t sn = 1; sn <= _SAROS_DB_SERIES; sn++) {
+        uint32_t begin = _saros_member(offsets, sn - 1u), end = _saros_member(offsets, sn);
+        if (begin > end)
+            return 0;
+        for (uint32_t m = begin; m < end; m++) {
+            uint32_t idx = _saros_member(members, m);
+            if (idx >= n || (m > begin && idx <= _saros_member(members, m - 1u)))
+                return 0;
+        }
+        if (end > begin) {
+            if (first == 0u)
+                first = (uint8_t)sn;
+            last = (uint8_t)sn;
+        }
+    }
+    if (!_saros_db_valid_links(s, _SAROS_DB_PREV) || !_saros_db_valid_links(s, _SAROS_DB_NEXT))
+        return 0;
+    if (!have_range) {
+        s->saros_first = first;
+        s->saros_last  = last;
+    } else if (first != 0u && (first < s->saros_first || last > s->saros_last)) {
+        return 0;
     }
-    /* lo = first index in 'indices[]' whose eclipse time >= timestamp */
+    if (s->sec[_SAROS_DB_CLASS] &&
+        s->len[_SAROS_DB_CLASS] != (size_t)_saros_classes[s->is_lunar] * ((n + 31u) / 32u) * 4u)
+        return 0;
+    if (s->sec[_SAROS_DB_DMAX] && !_saros_db_valid_dmax(s))
+        return 0;
+    if ((s->sec[_SAROS_DB_GEO_OFFSETS] || s->sec[_SAROS_DB_GEO_MEMBERS]) &&
+        !_saros_db_valid_geo(s))
+        return 0;
+    return 1;
+}
 
-    if (lo < count)
-        w.future = _make_entry(_SAROS_TIMES_ARR, _SAROS_INFO_ARR, indices[lo],      0);
-    if (lo > 0u)
-        w.past   = _make_entry(_SAROS_TIMES_ARR, _SAROS_INFO_ARR, indices[lo - 1u], 0);
+/* ── Opening ────────────────────────────────────────────────────────────── */
 
-    return w;
+/* Map the .db files of dir/kind into s.  A missing eclipse_times.db leaves s empty. */
+static int _saros_db_open_set(saros_db_t *db, _saros_db_set_t *s,
+                              const char *dir, const char *kind)
+{
+    char path[4096];
+    for (uint32_t f = 0; f < _SAROS_DB_FILES; f++) {
+        int len = snprintf(path, sizeof(path), "%s/%s/%s", dir, kind, _saros_db_names[f]);
+        if (len < 0 || (size_t)len >= sizeof(path)) {
+            errno = ENAMETOOLONG;
+            return 0;
+        }
+        if (!_saros_db_keep(db, path, &s->sec[f], &s->len[f]))
+            return f == 0u && errno == ENOENT;
+    }
+    if (!_saros_db_valid(s, 0)) {
+        errno = EINVAL;
+        return 0;
+    }
+    return 1;
 }
 
-#endif /* SAROS_IMPL_SOLAR */
+static int _saros_db_open_dir(saros_db_t *db, const char *dir)
+{
+    return _saros_db_open_set(db, &db->set[ECLIPSE_KIND_SOLAR], dir, "solar") &&
+           _saros_db_open_set(db, &db->set[ECLIPSE_KIND_LUNAR], dir, "lunar");
+}
 
-/* ────────────────────────────────────────────────────────────────────────── *
- * LUNAR implementation                                                       *
- * ────────────────────────────────────────────────────────────────────────── */
-#if defined(SAROS_IMPL_LUNAR)
+static inline uint32_t _saros_db_u16(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8;
+}
 
-static eclipse_result_t _lunar_build(uint32_t focal_idx)
+static inline uint32_t _saros_db_u32(const uint8_t *p)
 {
-    eclipse_result_t r;
-    memset(&r, 0, sizeof(r));
-    r.eclipse = _make_entry(_SAROS_TIMES_ARR, _SAROS_INFO_ARR, focal_idx, /*lunar=*/1);
-    _saros_neighbours(
-        _SAROS_TIMES_ARR, _SAROS_INFO_ARR, _SAROS_SAROS_ARR,
-        _SAROS_FIRST, _SAROS_LAST,
-        r.eclipse.info.lunar.saros_number,
-        r.eclipse.info.lunar.saros_pos,
-        /*lunar=*/1,
-        &r.saros_prev, &r.saros_next);
-    return r;
+    return _saros_db_u16(p) | _saros_db_u16(p + 2) << 16;
 }
 
-eclipse_result_t find_next_lunar_eclipse(int64_t timestamp)
+static inline uint64_t _saros_db_u64(const uint8_t *p)
 {
-    eclipse_result_t empty;
-    memset(&empty, 0, sizeof(empty));
-    uint32_t idx = _lower_bound(_SAROS_TIMES_ARR, _SAROS_COUNT, timestamp);
-    if (idx >= _SAROS_COUNT)
-        return empty;
-    return _lunar_build(idx);
+    return (uint64_t)_saros_db_u32(p) | (uint64_t)_saros_db_u32(p + 4) << 32;
 }
 
-eclipse_result_t find_past_lunar_eclipse(int64_t timestamp)
+/*
+ * Checks the container header and its CRC, then every section (bounds,
+ * alignment, CRC, no repeats), and points the sets into the mapping.  A
+ * kind with no sections stays empty.
+ */
+static int _saros_db_parse(saros_db_t *db, const uint8_t *p, size_t len)
 {
-    eclipse_result_t empty;
-    memset(&empty, 0, sizeof(empty));
-    uint32_t idx = _upper_bound(_SAROS_TIMES_ARR, _SAROS_COUNT, timestamp);
-    if (idx == 0u)
-        return empty;
-    return _lunar_build(idx - 1u);
+    static const uint8_t magic[8] = { 'S', 'A', 'R', 'O', 'S', 'D', 'B', 0 };
+    static const uint8_t zero[4]  = { 0, 0, 0, 0 };
+    if (len < _SAROS_DB_HEADER_SIZE || memcmp(p, magic, sizeof(magic)) != 0 ||
+        _saros_db_u16(p + 8) != _SAROS_DB_VERSION ||
+        _saros_db_u16(p + 10) != _SAROS_DB_HEADER_SIZE ||
+        _saros_db_u16(p + 14) != _SAROS_DB_ENTRY_SIZE ||
+        _saros_db_u64(p + 16) != (uint64_t)len)
+        return 0;
+    uint32_t sections = _saros_db_u16(p + 12);
+    size_t   table    = (size_t)sections * _SAROS_DB_ENTRY_SIZE;
+    if (table > len - _SAROS_DB_HEADER_SIZE)
+        return 0;
+    /* the header with its CRC field zeroed, then the section table */
+    uint32_t crc = _saros_crc32c(0u, p, 24u);
+    crc = _saros_crc32c(crc, zero, 4u);
+    crc = _saros_crc32c(crc, p + 28, _SAROS_DB_HEADER_SIZE - 28u + table);
+    if (crc != _saros_db_u32(p + 24))
+        return 0;
+
+    uint32_t seen[2] = { 0u, 0u };
+    for (uint32_t i = 0; i < sections; i++) {
+        const uint8_t *e = p + _SAROS_DB_HEADER_SIZE + i * _SAROS_DB_ENTRY_SIZE;
+        uint32_t kind = e[0], sec = e[1] - 1u;
+        uint64_t off  = _saros_db_u64(e + 8), size = _saros_db_u64(e + 16);
+        if (kind > 1u || sec >= _SAROS_DB_SECTIONS || (seen[kind] >> sec & 1u) ||
+            off % _SAROS_DB_ALIGN != 0u || off > len || size > len - off ||
+            _saros_crc32c(0u, p + off, (size_t)size) != _saros_db_u32(e + 4))
+            return 0;
+        _saros_db_set_t *s = &db->set[kind];
+        seen[kind] |= 1u << sec;
+        s->sec[sec] = size ? p + off : NULL;
+        s->len[sec] = (size_t)size;
+        if (sec == _SAROS_DB_DMAX)
+            s->dmax_leaves = _saros_db_u32(e + 24);
+        else if (sec == _SAROS_DB_GEO_OFFSETS)
+            s->geo_cell = _saros_db_u32(e + 24);
+    }
+    for (uint32_t k = 0; k < 2u; k++) {
+        _saros_db_set_t *s = &db->set[k];
+        s->saros_first = p[36 + 8 * k];
+        s->saros_last  = p[37 + 8 * k];
+        if (seen[k] && (!_saros_db_valid(s, 1) || s->count != _saros_db_u32(p + 32 + 8 * k)))
+            return 0;
+    }
+    return 1;
 }
 
-saros_window_t find_lunar_saros_window(int64_t timestamp, uint8_t saros_number)
+static int _saros_db_open_file(saros_db_t *db, const char *path)
 {
-    saros_window_t w;
-    memset(&w, 0, sizeof(w));
-    w.saros_number = saros_number;
+    const uint8_t *p;
+    size_t len;
+    if (!_saros_db_keep(db, path, &p, &len))
+        return 0;
+    if (!_saros_db_parse(db, p, len)) {
+        errno = EINVAL;
+        return 0;
+    }
+    return 1;
+}
 
-    if (saros_number < _SAROS_FIRST || saros_number > _SAROS_LAST)
-        return w;
+/*
+ * The set as a saros_ctx_t pointing into its sections; its series index
+ * covers series 1-180, like the "all" headers it copies.
+ */
+static void _saros_db_bind(saros_db_t *db, eclipse_kind_t kind)
+{
+    const _saros_db_set_t *s = &db->set[kind];
+    saros_ctx_t *c = &db->ctx[kind];
+    c->kind           = kind;
+    c->count          = s->count;
+    c->times          = s->sec[_SAROS_DB_TIMES];
+    c->info           = s->sec[_SAROS_DB_INFO];
+    c->saros_offsets  = s->sec[_SAROS_DB_SAROS_OFFSETS];
+    c->saros_members  = s->sec[_SAROS_DB_SAROS_MEMBERS];
+    c->prev_in_series = s->sec[_SAROS_DB_PREV];
+    c->next_in_series = s->sec[_SAROS_DB_NEXT];
+    c->class_bitmaps  = s->sec[_SAROS_DB_CLASS];
+    c->dmax           = s->sec[_SAROS_DB_DMAX];
+    c->dmax_leaves    = s->dmax_leaves;
+    c->geo_offsets    = s->sec[_SAROS_DB_GEO_OFFSETS];
+    c->geo_members    = s->sec[_SAROS_DB_GEO_MEMBERS];
+    c->geo_cell       = s->geo_cell;
+    if (c->saros_offsets) {
+        c->saros_first = 1u;
+        c->saros_last  = (uint8_t)_SAROS_DB_SERIES;
+    }
+}
 
-    uint8_t  count = 0;
-    uint16_t indices[SAROS_MAX_ECLIPSES];
-    _saros_load_series(_SAROS_SAROS_ARR, saros_number, _SAROS_FIRST, &count, indices);
+/* ── Lookups ────────────────────────────────────────────────────────────── */
 
-    if (count == 0u)
-        return w;
+static inline const saros_ctx_t *_saros_db_ctx(const saros_db_t *db, eclipse_kind_t kind)
+{
+    return &db->ctx[kind == ECLIPSE_KIND_LUNAR];
+}
 
-    uint8_t lo = 0, hi = count;
-    while (lo < hi) {
-        uint8_t mid = lo + (hi - lo) / 2u;
-        int64_t t = _saros_read_time(_SAROS_TIMES_ARR, indices[mid]);
-        if (t < timestamp)
-            lo = mid + 1u;
-        else
-            hi = mid;
+saros_db_t *saros_db_open(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return NULL;
+    saros_db_t *db = (saros_db_t *)calloc(1u, sizeof(*db));
+    if (!db)
+        return NULL;
+    db->set[ECLIPSE_KIND_LUNAR].is_lunar = 1;
+    if (!(S_ISDIR(st.st_mode) ? _saros_db_open_dir(db, path)
+                              : _saros_db_open_file(db, path))) {
+        int err = errno;
+        saros_db_close(db);
+        errno = err;
+        return NULL;
     }
+    if (!db->set[ECLIPSE_KIND_SOLAR].sec[_SAROS_DB_SAROS_OFFSETS] &&
+        !db->set[ECLIPSE_KIND_LUNAR].sec[_SAROS_DB_SAROS_OFFSETS]) {
+        saros_db_close(db);
+        errno = ENOENT;
+        return NULL;
+    }
+    _saros_db_bind(db, ECLIPSE_KIND_SOLAR);
+    _saros_db_bind(db, ECLIPSE_KIND_LUNAR);
+    return db;
+}
+
+void saros_db_close(saros_db_t *db)
+{
+    if (!db)
+        return;
+    for (uint32_t m = 0; m < db->maps; m++)
+        munmap(db->map[m], db->map_len[m]);
+    free(db);
+}
 
-    if (lo < count)
-        w.future = _make_entry(_SAROS_TIMES_ARR, _SAROS_INFO_ARR, indices[lo],      1);
-    if (lo > 0u)
-        w.past   = _make_entry(_SAROS_TIMES_ARR, _SAROS_INFO_ARR, indices[lo - 1u], 1);
+uint32_t saros_db_count(const saros_db_t *db, eclipse_kind_t kind)
+{
+    return _saros_db_ctx(db, kind)->count;
+}
 
-    return w;
+void saros_db_saros_range(const saros_db_t *db, eclipse_kind_t kind,
+                          uint8_t *first, uint8_t *last)
+{
+    const _saros_db_set_t *s = &db->set[kind == ECLIPSE_KIND_LUNAR];
+    *first = s->saros_first;
+    *last  = s->saros_last;
 }
 
-#endif /* SAROS_IMPL_LUNAR */
+eclipse_result_t saros_db_find_next(const saros_db_t *db, eclipse_kind_t kind,
+                                    int64_t timestamp)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _saros_ctx_result(c, _saros_ctx_lower(c, timestamp));
+}
+
+eclipse_result_t saros_db_find_past(const saros_db_t *db, eclipse_kind_t kind,
+                                    int64_t timestamp)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _saros_ctx_result(c, _saros_ctx_upper(c, timestamp) - 1u);
+}
+
+eclipse_result_t saros_db_find_closest(const saros_db_t *db, eclipse_kind_t kind,
+                                       int64_t timestamp)
+{
+    return _saros_ctx_result(_saros_db_ctx(db, kind),
+                             saros_db_closest_index(db, kind, timestamp));
+}
+
+saros_window_t saros_db_saros_window(const saros_db_t *db, eclipse_kind_t kind,
+                                     int64_t timestamp, uint8_t saros_number)
+{
+    return _saros_ctx_window(_saros_db_ctx(db, kind), timestamp, saros_number);
+}
+
+eclipse_result_t saros_db_find_next_of(const saros_db_t *db, eclipse_kind_t kind,
+                                       int64_t timestamp, uint32_t type_mask)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _saros_ctx_result(c, _saros_ctx_next_of(c, _saros_ctx_lower(c, timestamp),
+                                                   c->count, type_mask));
+}
+
+eclipse_result_t saros_db_find_past_of(const saros_db_t *db, eclipse_kind_t kind,
+                                       int64_t timestamp, uint32_t type_mask)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _saros_ctx_result(c, _saros_ctx_past_of(c, _saros_ctx_upper(c, timestamp),
+                                                   type_mask));
+}
+
+eclipse_result_t saros_db_find_next_min_duration(const saros_db_t *db, eclipse_kind_t kind,
+                                                 int64_t timestamp, lunar_phase_t phase,
+                                                 uint16_t secs)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _saros_ctx_result(c, _saros_ctx_next_min(c, _saros_ctx_lower(c, timestamp),
+                                                    phase, secs));
+}
+
+eclipse_result_t saros_db_find_past_min_duration(const saros_db_t *db, eclipse_kind_t kind,
+                                                 int64_t timestamp, lunar_phase_t phase,
+                                                 uint16_t secs)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _saros_ctx_result(c, _saros_ctx_past_min(c, _saros_ctx_upper(c, timestamp),
+                                                    phase, secs));
+}
+
+void saros_db_find_next_batch(const saros_db_t *db, eclipse_kind_t kind,
+                              const int64_t *timestamps, size_t n, eclipse_result_t *out)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    _saros_batch(c->times, c->count, timestamps, n, _SAROS_CACHE_NEXT,
+                 _saros_ctx_build, c, out);
+}
+
+void saros_db_find_past_batch(const saros_db_t *db, eclipse_kind_t kind,
+                              const int64_t *timestamps, size_t n, eclipse_result_t *out)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    _saros_batch(c->times, c->count, timestamps, n, _SAROS_CACHE_PAST,
+                 _saros_ctx_build, c, out);
+}
+
+uint32_t saros_db_next_index(const saros_db_t *db, eclipse_kind_t kind, int64_t timestamp)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    uint32_t idx = _saros_ctx_lower(c, timestamp);
+    return (idx < c->count) ? idx : SAROS_NO_ECLIPSE;
+}
+
+uint32_t saros_db_past_index(const saros_db_t *db, eclipse_kind_t kind, int64_t timestamp)
+{
+    uint32_t idx = _saros_ctx_upper(_saros_db_ctx(db, kind), timestamp);
+    return (idx > 0u) ? idx - 1u : SAROS_NO_ECLIPSE;
+}
+
+uint32_t saros_db_closest_index(const saros_db_t *db, eclipse_kind_t kind, int64_t timestamp)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _saros_closest(c->times, c->count, _saros_ctx_lower(c, timestamp), timestamp);
+}
+
+int64_t saros_db_time(const saros_db_t *db, eclipse_kind_t kind, uint32_t idx)
+{
+    return _saros_read_time(_saros_db_ctx(db, kind)->times, idx);
+}
+
+uint8_t saros_db_type(const saros_db_t *db, eclipse_kind_t kind, uint32_t idx)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _saros_type_at(c->info, idx, _saros_ctx_lunar(c));
+}
+
+eclipse_entry_t saros_db_entry(const saros_db_t *db, eclipse_kind_t kind, uint32_t idx)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    return _make_entry(c->times, c->info, idx, _saros_ctx_lunar(c));
+}
+
+void saros_db_neighbours(const saros_db_t *db, eclipse_kind_t kind,
+                         uint32_t idx, uint32_t *prev, uint32_t *next)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    *prev = _saros_link(c->prev_in_series, idx);
+    *next = _saros_link(c->next_in_series, idx);
+}
+
+eclipse_result_t saros_db_result(const saros_db_t *db, eclipse_kind_t kind, uint32_t idx)
+{
+    return _saros_ctx_build(_saros_db_ctx(db, kind), idx);
+}
+
+eclipse_range_t saros_db_range(const saros_db_t *db, eclipse_kind_t kind,
+                               int64_t t0, int64_t t1)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, kind);
+    if (t1 <= t0)
+        return _saros_range(0u, 0u);
+    return _saros_range(_saros_ctx_lower(c, t0), _saros_ctx_lower(c, t1));
+}
+
+int saros_db_range_next(eclipse_range_t *range)
+{
+    return _saros_range_next(range);
+}
+
+int saros_db_range_next_of(const saros_db_t *db, eclipse_kind_t kind,
+                           eclipse_range_t *range, uint32_t type_mask)
+{
+    return _saros_ctx_range_next_of(_saros_db_ctx(db, kind), range, type_mask);
+}
+
+uint32_t saros_db_find_solar_near(const saros_db_t *db,
+                                  double lat, double lon, double radius_km,
+                                  int64_t t0, int64_t t1,
+                                  solar_near_fn cb, void *user)
+{
+    const saros_ctx_t *c = _saros_db_ctx(db, ECLIPSE_KIND_SOLAR);
+    if (t1 <= t0)
+        return 0;
+    return _saros_near(c->info, c->geo_offsets, c->geo_members, c->geo_cell,
+                       _saros_ctx_lower(c, t0), _saros_ctx_lower(c, t1),
+                       lat, lon, radius_km, cb, user);
+}
+
+/* ── Hot swap ───────────────────────────────────────────────────────────── *
+ * A reader counts itself in readers[epoch & 1], then reads the epoch again:
+ * if a swap moved it in between, it steps out and retries on the other
+ * counter.  A swap exchanges the handle, bumps the epoch and waits for the
+ * counter of the old parity to drain.  Any reader that could have loaded
+ * the old handle was counted there before the bump (its second read of the
+ * epoch proves it), and any reader counted later loads the new handle, so
+ * the old one is unreachable once that counter reads zero.  The counter
+ * and epoch accesses are sequentially consistent, which that argument
+ * needs; the handle is published with release and loaded with acquire.
+ */
+struct saros_db_live {
+    saros_db_t      *db;
+    uint32_t         epoch;
+    uint32_t         readers[2];
+    pthread_mutex_t  writer;                   /* serialises swaps only */
+};
+
+saros_db_live_t *saros_db_live_create(saros_db_t *db)
+{
+    if (!db) {
+        errno = EINVAL;
+        return NULL;
+    }
+    saros_db_live_t *live = (saros_db_live_t *)calloc(1, sizeof(*live));
+    if (!live)
+        return NULL;
+    if (pthread_mutex_init(&live->writer, NULL) != 0) {
+        free(live);
+        errno = ENOMEM;
+        return NULL;
+    }
+    live->db = db;
+    return live;
+}
+
+const saros_db_t *saros_db_live_acquire(saros_db_live_t *live, uint32_t *ticket)
+{
+    for (;;) {
+        uint32_t epoch = __atomic_load_n(&live->epoch, __ATOMIC_SEQ_CST);
+        uint32_t slot  = epoch & 1u;
+        __atomic_add_fetch(&live->readers[slot], 1u, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&live->epoch, __ATOMIC_SEQ_CST) == epoch) {
+            *ticket = slot;
+            return __atomic_load_n(&live->db, __ATOMIC_ACQUIRE);
+        }
+        __atomic_sub_fetch(&live->readers[slot], 1u, __ATOMIC_RELEASE);
+    }
+}
+
+void saros_db_live_release(saros_db_live_t *live, uint32_t ticket)
+{
+    __atomic_sub_fetch(&live->readers[ticket & 1u], 1u, __ATOMIC_RELEASE);
+}
+
+int saros_db_live_swap(saros_db_live_t *live, saros_db_t *db)
+{
+    if (!db) {
+        errno = EINVAL;
+        return -1;
+    }
+    pthread_mutex_lock(&live->writer);
+    saros_db_t *old = __atomic_exchange_n(&live->db, db, __ATOMIC_SEQ_CST);
+    uint32_t slot = __atomic_fetch_add(&live->epoch, 1u, __ATOMIC_SEQ_CST) & 1u;
+    while (__atomic_load_n(&live->readers[slot], __ATOMIC_SEQ_CST) != 0u)
+        sched_yield();
+    pthread_mutex_unlock(&live->writer);
+    saros_db_close(old);
+    return 0;
+}
+
+void saros_db_live_destroy(saros_db_live_t *live)
+{
+    if (!live)
+        return;
+    pthread_mutex_destroy(&live->writer);
+    saros_db_close(live->db);
+    free(live);
+}
+
+#undef _SAROS_DB_TIMES
+#undef _SAROS_DB_INFO
+#undef _SAROS_DB_SAROS_OFFSETS
+#undef _SAROS_DB_SAROS_MEMBERS
+#undef _SAROS_DB_PREV
+#undef _SAROS_DB_NEXT
+#undef _SAROS_DB_CLASS
+#undef _SAROS_DB_DMAX
+#undef _SAROS_DB_GEO_OFFSETS
+#undef _SAROS_DB_GEO_MEMBERS
+#undef _SAROS_DB_SECTIONS
+#undef _SAROS_DB_FILES
+#undef _SAROS_DB_SERIES
+#undef _SAROS_DB_VERSION
+#undef _SAROS_DB_HEADER_SIZE
+#undef _SAROS_DB_ENTRY_SIZE
+#undef _SAROS_DB_ALIGN
+#endif /* SAROS_IMPL_DB */
 
 /* Clean up internal macros */
 #undef _SAROS_TIMES_ARR
 #undef _SAROS_INFO_ARR
-#undef _SAROS_SAROS_ARR
+#undef _SAROS_OFFSETS_ARR
+#undef _SAROS_MEMBERS_ARR
+#undef _SAROS_PREV_ARR
+#undef _SAROS_NEXT_ARR
+#undef _SAROS_CLASS_ARR
+#undef _SAROS_DMAX_ARR
+#undef _SAROS_DMAX_LEAVES
+#undef _SAROS_GEO_OFFSETS_ARR
+#undef _SAROS_GEO_MEMBERS_ARR
+#undef _SAROS_GEO_CELL
 #undef _SAROS_COUNT
 #undef _SAROS_FIRST
 #undef _SAROS_LAST
+#undef _SAROS_LOWER_BOUND
+#undef _SAROS_UPPER_BOUND
+#undef _SAROS_SOLAR_COUNT
+#undef _SAROS_LUNAR_COUNT
+#undef _SAROS_SLICE
+#undef _SAROS_SLICE_UC
+#undef _SAROS_SYM
+#undef _SAROS_SYM_
+#undef _SAROS_SYM__
+#undef _SAROS_CONST
+#undef _SAROS_CONST_
+#undef _SAROS_CONST__
+#ifdef SAROS_LAYOUT_EYTZINGER
+#  undef _SAROS_EYTZ_ARR
+#  undef _SAROS_EYTZ_RANK_ARR
+#endif
+#ifdef SAROS_USE_BUCKET_INDEX
+#  undef _SAROS_BUCKET_ARR
+#  undef _SAROS_BUCKET_COUNT
+#  undef _SAROS_BUCKET_SHIFT
+#  undef _SAROS_BUCKET_ORIGIN
+#endif
 
-#endif /* SAROS_IMPL_SOLAR || SAROS_IMPL_LUNAR */
+#endif /* SAROS_IMPL_SOLAR || SAROS_IMPL_LUNAR || SAROS_IMPL_DB || SAROS_IMPL_CTX */
+
+/* ══════════════════════════════════════════════════════════════════════════ *
+ * Solar + lunar — compiled with both kinds in one translation unit, or on    *
+ * its own with SAROS_IMPL_TIMELINE.  Uses the public per-kind API only.      *
+ * ══════════════════════════════════════════════════════════════════════════ */
+#if (defined(SAROS_IMPL_SOLAR) && defined(SAROS_IMPL_LUNAR)) || defined(SAROS_IMPL_TIMELINE)
+
+/* Decode whichever of solar si / lunar li is the answer: the earlier one
+ * for find_next, the later one (later=1) for find_past. */
+static eclipse_any_result_t _eclipse_any(uint32_t si, uint32_t li, int later)
+{
+    eclipse_any_result_t r;
+    int lunar;
+
+    if (si == SAROS_NO_ECLIPSE && li == SAROS_NO_ECLIPSE) {
+        memset(&r, 0, sizeof(r));
+        r.kind = ECLIPSE_KIND_SOLAR;
+        return r;
+    }
+    if (si == SAROS_NO_ECLIPSE)
+        lunar = 1;
+    else if (li == SAROS_NO_ECLIPSE)
+        lunar = 0;
+    else {
+        const int64_t ts = saros_solar_time(si);
+        const int64_t tl = saros_lunar_time(li);
+        lunar = later ? (tl > ts) : (tl < ts);
+    }
+    r.kind   = lunar ? ECLIPSE_KIND_LUNAR : ECLIPSE_KIND_SOLAR;
+    r.result = lunar ? saros_lunar_result(li) : saros_solar_result(si);
+    return r;
+}
+
+eclipse_any_result_t find_next_eclipse_any(int64_t timestamp)
+{
+    return _eclipse_any(find_next_solar_index(timestamp),
+                        find_next_lunar_index(timestamp), /*later=*/0);
+}
+
+eclipse_any_result_t find_past_eclipse_any(int64_t timestamp)
+{
+    return _eclipse_any(find_past_solar_index(timestamp),
+                        find_past_lunar_index(timestamp), /*later=*/1);
+}
+
+static void _timeline_pull_solar(eclipse_timeline_t *tl)
+{
+    tl->solar_live = (uint8_t)solar_range_next(&tl->solar);
+    if (tl->solar_live)
+        tl->solar_time = solar_range_time(&tl->solar);
+}
+
+static void _timeline_pull_lunar(eclipse_timeline_t *tl)
+{
+    tl->lunar_live = (uint8_t)lunar_range_next(&tl->lunar);
+    if (tl->lunar_live)
+        tl->lunar_time = lunar_range_time(&tl->lunar);
+}
+
+eclipse_timeline_t eclipse_timeline(int64_t t0, int64_t t1)
+{
+    eclipse_timeline_t tl;
+    memset(&tl, 0, sizeof(tl));
+    tl.kind  = ECLIPSE_KIND_SOLAR;
+    tl.index = SAROS_NO_ECLIPSE;
+    tl.solar = solar_eclipse_range(t0, t1);
+    tl.lunar = lunar_eclipse_range(t0, t1);
+    _timeline_pull_solar(&tl);
+    _timeline_pull_lunar(&tl);
+    return tl;
+}
+
+int eclipse_timeline_next(eclipse_timeline_t *tl)
+{
+    if (tl->solar_live && (!tl->lunar_live || tl->solar_time <= tl->lunar_time)) {
+        tl->kind  = ECLIPSE_KIND_SOLAR;
+        tl->index = tl->solar.index;
+        tl->time  = tl->solar_time;
+        _timeline_pull_solar(tl);
+        return 1;
+    }
+    if (tl->lunar_live) {
+        tl->kind  = ECLIPSE_KIND_LUNAR;
+        tl->index = tl->lunar.index;
+        tl->time  = tl->lunar_time;
+        _timeline_pull_lunar(tl);
+        return 1;
+    }
+    return 0;
+}
+
+eclipse_entry_t eclipse_timeline_entry(const eclipse_timeline_t *tl)
+{
+    eclipse_entry_t e;
+    memset(&e, 0, sizeof(e));
+    e.unix_time    = tl->time;
+    e.global_index = (uint16_t)tl->index;
+    if (tl->kind == ECLIPSE_KIND_LUNAR)
+        e.info.lunar = saros_lunar_info(tl->index);
+    else
+        e.info.solar = saros_solar_info(tl->index);
+    e.valid = 1;
+    return e;
+}
+
+#endif /* (SAROS_IMPL_SOLAR && SAROS_IMPL_LUNAR) || SAROS_IMPL_TIMELINE */
 
 #endif /* SAROS_H */
@@ -0,0 +1,871 @@
+/*
+ * saros.hpp — compile-time eclipse lookups for C++20 (header-only)
+ *
+ * ── Usage ─────────────────────────────────────────────────────────────────
+ *
+ *   #include "solar/eclipse_times_modern.h"
+ *   #include "solar/eclipse_info_modern.h"
+ *   #include "solar/saros_modern.h"
+ *   #include "saros.hpp"
+ *
+ *   constexpr eclipse_result_t r = saros::next_eclipse(saros::solar_modern, 1700000000);
+ *   static_assert(r.eclipse.valid);
+ *
+ * Each dataset whose times, info and saros headers are included before this
+ * file becomes an inline constexpr saros::dataset, decoded from the header
+ * bytes at compile time:
+ *   saros::solar_modern, saros::solar_all, saros::lunar_modern, saros::lunar_all
+ * The data headers declare their arrays constexpr when compiled as C++, which
+ * is what lets this header read them in constant expressions.
+ *
+ * The lookups are constexpr and return what the C calls of the same dataset
+ * return, field for field:
+ *   next_eclipse / past_eclipse / closest_eclipse, saros_window,
+ *   next_eclipse_of / past_eclipse_of,
+ *   next_eclipse_min_duration / past_eclipse_min_duration,
+ *   next_index / past_index, entry, result.
+ * With a constant timestamp the whole lookup folds into the binary as a
+ * constant.  Loading this header also checks each dataset with
+ * static_assert: timestamps sorted, the series index a partition of the
+ * eclipses in time order, the series links matching it.
+ *
+ * ── Policies ──────────────────────────────────────────────────────────────
+ *   One engine<Kind, Slice> serves all four datasets.  The Kind policy
+ *   (solar_kind, lunar_kind) supplies the info type, its decoder, how it is
+ *   stored in an eclipse_entry_t and which duration a phase reads; the Slice
+ *   policy (modern_slice, all_slice) selects the arrays, and with them the
+ *   count and Saros range as constants.  Every instantiation is therefore
+ *   specialized for one kind and one slice, with no kind test at run time.
+ *   The free functions above deduce the engine from the dataset.
+ *
+ * ── Ranges ────────────────────────────────────────────────────────────────
+ *   saros::solar() and saros::lunar() are random-access views over the
+ *   default slice (modern, or all under SAROS_USE_ALL; solar<all_slice>()
+ *   picks one), and eclipses(d) over any dataset.  Their elements are
+ *   eclipse_entry_t, built when dereferenced; times() and info() are the
+ *   columns as spans.  Queries compose lazily:
+ *
+ *     for (eclipse_entry_t e : saros::solar() | saros::in_range(t0, t1)
+ *                                             | saros::of_type(saros::solar_kind::total)
+ *                                             | saros::in_series(145)
+ *                                             | saros::take(10))
+ *
+ *   in_range() narrows the view by binary search and keeps it random-access.
+ *   of_type() and in_series() give a forward view that walks the range, or
+ *   the series' own members, and tests the type and series fields of each
+ *   record before building an entry for it; no container is filled.
+ *
+ * Needs only saros.h for the types, no SAROS_IMPL_* unit.  Only the plain
+ * headers are read (not the packed or column-split ones).  At run time the
+ * calls read the decoded copy, 24 bytes per eclipse; on PROGMEM targets
+ * keep to constant expressions and use the C API at run time.  Decoding the
+ * "all" slices takes a few seconds per translation unit; clang needs
+ * -fconstexpr-steps raised for them.
+ */
+
+#ifndef SAROS_HPP
+#define SAROS_HPP
+
+#if __cplusplus < 202002L
+#  error "saros.hpp needs C++20"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <span>
+
+#include "saros.h"
+
+namespace saros {
+
+namespace detail {
+
+inline constexpr uint16_t link_none = 0xFFFFu;
+
+constexpr uint16_t read_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+constexpr int64_t read_i64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    for (int i = 8; i-- > 0; )
+        v = (v << 8) | p[i];
+    return (int64_t)v;
+}
+
+}  // namespace detail
+
+/* ── Kind policies ──────────────────────────────────────────────────────── */
+
+/** Solar eclipses: solar_eclipse_info_t, the central duration. */
+struct solar_kind {
+    using info_type = solar_eclipse_info_t;
+    using type_enum = solar_eclipse_type_t;
+    static constexpr eclipse_kind_t kind = ECLIPSE_KIND_SOLAR;
+
+    static constexpr uint32_t annular   = SOLAR_TYPES_ANNULAR;
+    static constexpr uint32_t hybrid    = SOLAR_TYPES_HYBRID;
+    static constexpr uint32_t partial   = SOLAR_TYPES_PARTIAL;
+    static constexpr uint32_t total     = SOLAR_TYPES_TOTAL;
+    static constexpr uint32_t all_types = annular | hybrid | partial | total;
+
+    /* Same fields as _decode_solar() in saros.h */
+    static constexpr info_type decode(const uint8_t *b)
+    {
+        info_type r{};
+        r.latitude_deg10   = (int16_t)detail::read_u16(b);
+        r.longitude_deg10  = (int16_t)detail::read_u16(b + 2);
+        r.central_duration = detail::read_u16(b + 4);
+        r.saros_number     = b[6];
+        r.saros_pos        = b[7];
+        r.ecl_type         = b[8];
+        r.sun_alt          = b[9];
+        return r;
+    }
+
+    static constexpr void store(eclipse_entry_t &e, const info_type &info)
+    {
+        e.info.solar = info;
+    }
+
+    /* Solar records have one duration; the phase is ignored */
+    static constexpr uint16_t duration(const info_type &info, lunar_phase_t)
+    {
+        return info.central_duration;
+    }
+};
+
+/** Lunar eclipses: lunar_eclipse_info_t, one duration per phase. */
+struct lunar_kind {
+    using info_type = lunar_eclipse_info_t;
+    using type_enum = lunar_eclipse_type_t;
+    static constexpr eclipse_kind_t kind = ECLIPSE_KIND_LUNAR;
+
+    static constexpr uint32_t penumbral = LUNAR_TYPES_PENUMBRAL;
+    static constexpr uint32_t partial   = LUNAR_TYPES_PARTIAL;
+    static constexpr uint32_t total     = LUNAR_TYPES_TOTAL;
+    static constexpr uint32_t all_types = penumbral | partial | total;
+
+    /* Same fields as _decode_lunar() in saros.h */
+    static constexpr info_type decode(const uint8_t *b)
+    {
+        info_type r{};
+        r.pen_duration   = detail::read_u16(b);
+        r.par_duration   = detail::read_u16(b + 2);
+        r.total_duration = detail::read_u16(b + 4);
+        r.saros_number   = b[6];
+        r.saros_pos      = b[7];
+        r.ecl_type       = b[8];
+        return r;
+    }
+
+    static constexpr void store(eclipse_entry_t &e, const info_type &info)
+    {
+        e.info.lunar = info;
+    }
+
+    static constexpr uint16_t duration(const info_type &info, lunar_phase_t phase)
+    {
+        return phase == LUNAR_PHASE_PENUMBRAL ? info.pen_duration
+             : phase == LUNAR_PHASE_PARTIAL   ? info.par_duration
+                                              : info.total_duration;
+    }
+};
+
+/* ── Slice policies ─────────────────────────────────────────────────────── */
+
+struct modern_slice {};   /**< Saros 110-173 */
+struct all_slice    {};   /**< Saros 1-180 */
+
+/**
+ * slice_traits<Kind, Slice> — the generated arrays of one dataset with
+ * their count, series count and Saros range.  Defined at the end of this
+ * file for each dataset whose headers were included.
+ */
+template <class Kind, class Slice>
+struct slice_traits;
+
+/* ── Datasets ───────────────────────────────────────────────────────────── */
+
+/**
+ * dataset — one kind and slice, decoded.  Series s holds
+ * saros_members[saros_offsets[s - saros_first] ..
+ * saros_offsets[s - saros_first + 1]), in time order; the series links are
+ * global indices, 0xFFFF for none.
+ */
+template <class Kind, class Slice>
+struct dataset {
+    using kind_type  = Kind;
+    using slice_type = Slice;
+    using info_type  = typename Kind::info_type;
+    using traits     = slice_traits<Kind, Slice>;
+
+    static constexpr eclipse_kind_t kind        = Kind::kind;
+    static constexpr std::size_t    count       = traits::count;
+    static constexpr std::size_t    series      = traits::series;
+    static constexpr uint8_t        saros_first = traits::saros_first;
+    static constexpr uint8_t        saros_last  = traits::saros_last;
+
+    std::array<int64_t, count>        times;
+    std::array<info_type, count>      info;
+    std::array<uint16_t, series + 1>  saros_offsets;
+    std::array<uint16_t, count>       saros_members;
+    std::array<uint16_t, count>       prev_in_series;
+    std::array<uint16_t, count>       next_in_series;
+};
+
+namespace detail {
+
+template <class Kind, class Slice>
+constexpr dataset<Kind, Slice> decode_dataset()
+{
+    using T = slice_traits<Kind, Slice>;
+    dataset<Kind, Slice> d{};
+    for (std::size_t i = 0; i < T::count; i++) {
+        d.times[i]          = read_i64(T::times + i * 8u);
+        d.info[i]           = Kind::decode(T::info + i * ECLIPSE_INFO_SIZE);
+        d.saros_members[i]  = read_u16(T::members + i * 2u);
+        d.prev_in_series[i] = read_u16(T::prev + i * 2u);
+        d.next_in_series[i] = read_u16(T::next + i * 2u);
+    }
+    for (std::size_t s = 0; s <= T::series; s++)
+        d.saros_offsets[s] = read_u16(T::offsets + s * 2u);
+    return d;
+}
+
+}  // namespace detail
+
+/** The decoded dataset of Kind and Slice. */
+template <class Kind, class Slice>
+inline constexpr dataset<Kind, Slice> catalog = detail::decode_dataset<Kind, Slice>();
+
+/* ── Engine ─────────────────────────────────────────────────────────────── */
+
+/**
+ * engine<Kind, Slice> — the lookups over one dataset.  d is normally
+ * catalog<Kind, Slice>; count and the Saros range are constants of the
+ * type, and the kind-specific steps come from the Kind policy.
+ */
+template <class Kind, class Slice>
+struct engine {
+    using data_type = dataset<Kind, Slice>;
+    using info_type = typename Kind::info_type;
+    static constexpr uint32_t count = (uint32_t)data_type::count;
+
+    /** First index with time >= timestamp; count if none. */
+    static constexpr uint32_t next_index(const data_type &d, int64_t timestamp)
+    {
+        return (uint32_t)(std::lower_bound(d.times.begin(), d.times.end(), timestamp) -
+                          d.times.begin());
+    }
+
+    /** Last index with time <= timestamp; SAROS_NO_ECLIPSE if none. */
+    static constexpr uint32_t past_index(const data_type &d, int64_t timestamp)
+    {
+        return (uint32_t)(std::upper_bound(d.times.begin(), d.times.end(), timestamp) -
+                          d.times.begin()) - 1u;
+    }
+
+    /** Entry idx, as _make_entry() builds it; valid = 0 for idx >= count. */
+    static constexpr eclipse_entry_t entry(const data_type &d, uint32_t idx)
+    {
+        eclipse_entry_t e{};
+        if (idx >= count)
+            return e;
+        e.unix_time    = d.times[idx];
+        e.global_index = (uint16_t)idx;
+        Kind::store(e, d.info[idx]);
+        e.valid = 1;
+        return e;
+    }
+
+    /** Eclipse idx with its series neighbours; empty for idx >= count. */
+    static constexpr eclipse_result_t result(const data_type &d, uint32_t idx)
+    {
+        eclipse_result_t r{};
+        if (idx >= count)
+            return r;
+        r.eclipse    = entry(d, idx);
+        r.saros_prev = entry(d, d.prev_in_series[idx]);
+        r.saros_next = entry(d, d.next_in_series[idx]);
+        return r;
+    }
+
+    static constexpr eclipse_result_t next(const data_type &d, int64_t timestamp)
+    {
+        return result(d, next_index(d, timestamp));
+    }
+
+    static constexpr eclipse_result_t past(const data_type &d, int64_t timestamp)
+    {
+        return result(d, past_index(d, timestamp));
+    }
+
+    /** The nearer of next and past, the later one on a tie. */
+    static constexpr eclipse_result_t closest(const data_type &d, int64_t timestamp)
+    {
+        uint32_t next = next_index(d, timestamp);
+        if (next == 0u || next == count)
+            return result(d, next == 0u ? 0u : next - 1u);
+        /* t[next-1] < timestamp <= t[next], so neither difference can overflow */
+        int64_t to_next = d.times[next] - timestamp;
+        int64_t to_past = timestamp - d.times[next - 1u];
+        return result(d, to_past < to_next ? next - 1u : next);
+    }
+
+    /** The series' last eclipse before timestamp and its first at or after it. */
+    static constexpr saros_window_t window(const data_type &d, int64_t timestamp,
+                                           uint8_t saros_number)
+    {
+        saros_window_t w{};
+        w.saros_number = saros_number;
+        if (count == 0u || saros_number < data_type::saros_first ||
+            saros_number > data_type::saros_last)
+            return w;
+
+        uint32_t s     = saros_number - data_type::saros_first;
+        auto     begin = d.saros_members.begin() + d.saros_offsets[s];
+        auto     end   = d.saros_members.begin() + d.saros_offsets[s + 1u];
+        auto     it    = std::partition_point(begin, end, [&](uint16_t m) {
+            return d.times[m] < timestamp;
+        });
+        if (it != end)
+            w.future = entry(d, *it);
+        if (it != begin)
+            w.past = entry(d, *(it - 1));
+        return w;
+    }
+
+    static constexpr bool of_type(const info_type &info, uint32_t type_mask)
+    {
+        return (type_mask >> (info.ecl_type & 31u)) & 1u;
+    }
+
+    /** A known duration of at least secs; 0xFFFF is n/a, so never. */
+    static constexpr bool lasts(const info_type &info, lunar_phase_t phase, uint16_t secs)
+    {
+        uint16_t dur = Kind::duration(info, phase);
+        return dur != 0xFFFFu && dur >= secs;
+    }
+
+    static constexpr eclipse_result_t next_of(const data_type &d, int64_t timestamp,
+                                              uint32_t type_mask)
+    {
+        uint32_t idx = next_index(d, timestamp);
+        while (idx < count && !of_type(d.info[idx], type_mask))
+            idx++;
+        return result(d, idx);
+    }
+
+    static constexpr eclipse_result_t past_of(const data_type &d, int64_t timestamp,
+                                              uint32_t type_mask)
+    {
+        uint32_t idx = past_index(d, timestamp);
+        while (idx < count && !of_type(d.info[idx], type_mask))
+            idx--;
+        return result(d, idx);
+    }
+
+    static constexpr eclipse_result_t next_min(const data_type &d, int64_t timestamp,
+                                               lunar_phase_t phase, uint16_t secs)
+    {
+        uint32_t idx = next_index(d, timestamp);
+        while (idx < count && !lasts(d.info[idx], phase, secs))
+            idx++;
+        return result(d, idx);
+    }
+
+    static constexpr eclipse_result_t past_min(const data_type &d, int64_t timestamp,
+                                               lunar_phase_t phase, uint16_t secs)
+    {
+        uint32_t idx = past_index(d, timestamp);
+        while (idx < count && !lasts(d.info[idx], phase, secs))
+            idx--;
+        return result(d, idx);
+    }
+};
+
+/* ── Lookups ────────────────────────────────────────────────────────────── */
+
+template <class K, class S>
+constexpr uint32_t next_index(const dataset<K, S> &d, int64_t timestamp)
+{
+    return engine<K, S>::next_index(d, timestamp);
+}
+
+template <class K, class S>
+constexpr uint32_t past_index(const dataset<K, S> &d, int64_t timestamp)
+{
+    return engine<K, S>::past_index(d, timestamp);
+}
+
+template <class K, class S>
+constexpr eclipse_entry_t entry(const dataset<K, S> &d, uint32_t idx)
+{
+    return engine<K, S>::entry(d, idx);
+}
+
+template <class K, class S>
+constexpr eclipse_result_t result(const dataset<K, S> &d, uint32_t idx)
+{
+    return engine<K, S>::result(d, idx);
+}
+
+/** find_next_*_eclipse(): the first eclipse at or after timestamp. */
+template <class K, class S>
+constexpr eclipse_result_t next_eclipse(const dataset<K, S> &d, int64_t timestamp)
+{
+    return engine<K, S>::next(d, timestamp);
+}
+
+/** find_past_*_eclipse(): the last eclipse at or before timestamp. */
+template <class K, class S>
+constexpr eclipse_result_t past_eclipse(const dataset<K, S> &d, int64_t timestamp)
+{
+    return engine<K, S>::past(d, timestamp);
+}
+
+/** find_closest_*_eclipse() */
+template <class K, class S>
+constexpr eclipse_result_t closest_eclipse(const dataset<K, S> &d, int64_t timestamp)
+{
+    return engine<K, S>::closest(d, timestamp);
+}
+
+/** find_*_saros_window() */
+template <class K, class S>
+constexpr saros_window_t saros_window(const dataset<K, S> &d, int64_t timestamp,
+                                      uint8_t saros_number)
+{
+    return engine<K, S>::window(d, timestamp, saros_number);
+}
+
+/** find_next_*_eclipse_of(); type_mask as for the C calls, e.g. K::total. */
+template <class K, class S>
+constexpr eclipse_result_t next_eclipse_of(const dataset<K, S> &d, int64_t timestamp,
+                                           uint32_t type_mask)
+{
+    return engine<K, S>::next_of(d, timestamp, type_mask);
+}
+
+template <class K, class S>
+constexpr eclipse_result_t past_eclipse_of(const dataset<K, S> &d, int64_t timestamp,
+                                           uint32_t type_mask)
+{
+    return engine<K, S>::past_of(d, timestamp, type_mask);
+}
+
+/** find_next_*_eclipse_min_duration(); phase is ignored for solar datasets. */
+template <class K, class S>
+constexpr eclipse_result_t next_eclipse_min_duration(const dataset<K, S> &d, int64_t timestamp,
+                                                     lunar_phase_t phase, uint16_t secs)
+{
+    return engine<K, S>::next_min(d, timestamp, phase, secs);
+}
+
+template <class K, class S>
+constexpr eclipse_result_t past_eclipse_min_duration(const dataset<K, S> &d, int64_t timestamp,
+                                                     lunar_phase_t phase, uint16_t secs)
+{
+    return engine<K, S>::past_min(d, timestamp, phase, secs);
+}
+
+/* ── Ranges ─────────────────────────────────────────────────────────────── */
+
+/**
+ * catalog_view — the eclipses [begin, end) of one dataset, in time order.
+ * Random-access and sized; dereferencing builds the eclipse_entry_t.
+ */
+template <class K, class S>
+class catalog_view : public std::ranges::view_interface<catalog_view<K, S>> {
+public:
+    using data_type = dataset<K, S>;
+    using info_type = typename K::info_type;
+
+    class iterator {
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;   /* yields values */
+        using value_type        = eclipse_entry_t;
+        using difference_type   = std::ptrdiff_t;
+
+        constexpr iterator() = default;
+        constexpr iterator(const data_type *d, uint32_t idx) : d_(d), idx_(idx) {}
+
+        constexpr eclipse_entry_t operator*() const { return engine<K, S>::entry(*d_, idx_); }
+        constexpr eclipse_entry_t operator[](difference_type n) const { return *(*this + n); }
+
+        /** Global index, and the raw columns of the current eclipse */
+        constexpr uint32_t         index() const { return idx_; }
+        constexpr int64_t          time() const { return d_->times[idx_]; }
+        constexpr const info_type &info() const { return d_->info[idx_]; }
+        constexpr eclipse_result_t result() const { return engine<K, S>::result(*d_, idx_); }
+
+        constexpr iterator &operator++() { ++idx_; return *this; }
+        constexpr iterator &operator--() { --idx_; return *this; }
+        constexpr iterator  operator++(int) { iterator t = *this; ++idx_; return t; }
+        constexpr iterator  operator--(int) { iterator t = *this; --idx_; return t; }
+        constexpr iterator &operator+=(difference_type n) { idx_ = (uint32_t)(idx_ + n); return *this; }
+        constexpr iterator &operator-=(difference_type n) { idx_ = (uint32_t)(idx_ - n); return *this; }
+
+        friend constexpr iterator operator+(iterator i, difference_type n) { return i += n; }
+        friend constexpr iterator operator+(difference_type n, iterator i) { return i += n; }
+        friend constexpr iterator operator-(iterator i, difference_type n) { return i -= n; }
+        friend constexpr difference_type operator-(const iterator &a, const iterator &b)
+        {
+            return (difference_type)a.idx_ - (difference_type)b.idx_;
+        }
+        friend constexpr bool operator==(const iterator &a, const iterator &b)
+        {
+            return a.idx_ == b.idx_;
+        }
+        friend constexpr auto operator<=>(const iterator &a, const iterator &b)
+        {
+            return a.idx_ <=> b.idx_;
+        }
+
+    private:
+        const data_type *d_   = nullptr;
+        uint32_t         idx_ = 0;
+    };
+
+    constexpr catalog_view() = default;
+    constexpr explicit catalog_view(const data_type &d)
+        : d_(&d), begin_(0), end_((uint32_t)data_type::count) {}
+    constexpr catalog_view(const data_type &d, uint32_t begin, uint32_t end)
+        : d_(&d), begin_(begin), end_(end) {}
+
+    constexpr iterator    begin() const { return iterator(d_, begin_); }
+    constexpr iterator    end() const { return iterator(d_, end_); }
+    constexpr std::size_t size() const { return end_ - begin_; }
+
+    /** The timestamp and info columns of the view */
+    constexpr std::span<const int64_t> times() const
+    {
+        return std::span<const int64_t>(d_->times).subspan(begin_, end_ - begin_);
+    }
+    constexpr std::span<const info_type> info() const
+    {
+        return std::span<const info_type>(d_->info).subspan(begin_, end_ - begin_);
+    }
+
+    /** The part of the view in [t0, t1), by binary search */
+    constexpr catalog_view in_range(int64_t t0, int64_t t1) const
+    {
+        uint32_t lo = std::clamp(engine<K, S>::next_index(*d_, t0), begin_, end_);
+        uint32_t hi = std::clamp(engine<K, S>::next_index(*d_, t1), lo, end_);
+        return catalog_view(*d_, lo, hi);
+    }
+
+    constexpr const data_type &data() const { return *d_; }
+    constexpr uint32_t         first() const { return begin_; }
+    constexpr uint32_t         last() const { return end_; }
+
+private:
+    const data_type *d_     = nullptr;
+    uint32_t         begin_ = 0, end_ = 0;
+};
+
+/**
+ * query_view — the eclipses of [begin, end) whose type bit is in a mask,
+ * optionally of one series only.  A forward view; each step tests the raw
+ * type and series of the records, and only a dereference builds an entry.
+ */
+template <class K, class S>
+class query_view : public std::ranges::view_interface<query_view<K, S>> {
+public:
+    using data_type = dataset<K, S>;
+    using info_type = typename K::info_type;
+
+    class iterator {
+    public:
+        using iterator_concept  = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;   /* yields values */
+        using value_type        = eclipse_entry_t;
+        using difference_type   = std::ptrdiff_t;
+
+        constexpr iterator() = default;
+        constexpr iterator(const data_type *d, bool by_series, uint32_t pos, uint32_t end,
+                           uint32_t type_mask)
+            : d_(d), by_series_(by_series), pos_(pos), end_(end), mask_(type_mask)
+        {
+            skip();
+        }
+
+        constexpr eclipse_entry_t operator*() const { return engine<K, S>::entry(*d_, index()); }
+
+        constexpr uint32_t index() const { return by_series_ ? d_->saros_members[pos_] : pos_; }
+        constexpr int64_t          time() const { return d_->times[index()]; }
+        constexpr const info_type &info() const { return d_->info[index()]; }
+        constexpr eclipse_result_t result() const { return engine<K, S>::result(*d_, index()); }
+
+        constexpr iterator &operator++() { ++pos_; skip(); return *this; }
+        constexpr iterator  operator++(int) { iterator t = *this; ++*this; return t; }
+
+        friend constexpr bool operator==(const iterator &a, const iterator &b)
+        {
+            return a.pos_ == b.pos_;
+        }
+        friend constexpr bool operator==(const iterator &i, std::default_sentinel_t)
+        {
+            return i.pos_ == i.end_;
+        }
+
+    private:
+        constexpr void skip()
+        {
+            while (pos_ < end_ && !engine<K, S>::of_type(d_->info[index()], mask_))
+                pos_++;
+        }
+
+        const data_type *d_         = nullptr;
+        bool             by_series_ = false;   /* pos indexes saros_members, not the catalog */
+        uint32_t         pos_ = 0, end_ = 0;
+        uint32_t         mask_ = 0;
+    };
+
+    constexpr query_view() = default;
+    constexpr query_view(const catalog_view<K, S> &v)
+        : d_(&v.data()), begin_(v.first()), end_(v.last()) {}
+
+    constexpr iterator begin() const
+    {
+        if (!series_)
+            return iterator(d_, false, begin_, end_, mask_);
+        /* member indices rise with time, so [begin, end) is a run of them */
+        if (series_ < data_type::saros_first || series_ > data_type::saros_last)
+            return iterator(d_, false, 0, 0, mask_);
+        uint32_t s  = series_ - data_type::saros_first;
+        auto     m0 = d_->saros_members.begin() + d_->saros_offsets[s];
+        auto     m1 = d_->saros_members.begin() + d_->saros_offsets[s + 1u];
+        auto     lo = std::partition_point(m0, m1, [&](uint16_t m) { return m < begin_; });
+        auto     hi = std::partition_point(lo, m1, [&](uint16_t m) { return m < end_; });
+        return iterator(d_, true,
+                        (uint32_t)(lo - d_->saros_members.begin()),
+                        (uint32_t)(hi - d_->saros_members.begin()), mask_);
+    }
+    constexpr std::default_sentinel_t end() const { return std::default_sentinel; }
+
+    constexpr query_view in_range(int64_t t0, int64_t t1) const
+    {
+        query_view q = *this;
+        q.begin_ = std::clamp(engine<K, S>::next_index(*d_, t0), begin_, end_);
+        q.end_   = std::clamp(engine<K, S>::next_index(*d_, t1), q.begin_, end_);
+        return q;
+    }
+
+    constexpr query_view of_type(uint32_t type_mask) const
+    {
+        query_view q = *this;
+        q.mask_ &= type_mask;
+        return q;
+    }
+
+    /** Two different series leave nothing */
+    constexpr query_view in_series(uint8_t saros_number) const
+    {
+        query_view q = *this;
+        if (series_ && series_ != saros_number)
+            q.end_ = q.begin_;
+        q.series_ = saros_number;
+        return q;
+    }
+
+private:
+    const data_type *d_      = nullptr;
+    uint32_t         begin_  = 0, end_ = 0;
+    uint32_t         mask_   = ~0u;
+    uint8_t          series_ = 0;    /* 0: every series */
+};
+
+/** A view over the whole of d. */
+template <class K, class S>
+constexpr catalog_view<K, S> eclipses(const dataset<K, S> &d)
+{
+    return catalog_view<K, S>(d);
+}
+
+#ifdef SAROS_USE_ALL
+using default_slice = all_slice;
+#else
+using default_slice = modern_slice;
+#endif
+
+template <class Slice = default_slice>
+constexpr catalog_view<solar_kind, Slice> solar()
+{
+    return catalog_view<solar_kind, Slice>(catalog<solar_kind, Slice>);
+}
+
+template <class Slice = default_slice>
+constexpr catalog_view<lunar_kind, Slice> lunar()
+{
+    return catalog_view<lunar_kind, Slice>(catalog<lunar_kind, Slice>);
+}
+
+namespace detail {
+
+struct in_range_fn  { int64_t t0, t1; };
+struct of_type_fn   { uint32_t type_mask; };
+struct in_series_fn { uint8_t saros_number; };
+
+}  // namespace detail
+
+/** [t0, t1), as the *_eclipse_range() calls take it */
+constexpr detail::in_range_fn in_range(int64_t t0, int64_t t1) { return { t0, t1 }; }
+
+/** A type_mask as for the *_of() calls, e.g. solar_kind::total */
+constexpr detail::of_type_fn of_type(uint32_t type_mask) { return { type_mask }; }
+
+constexpr detail::in_series_fn in_series(uint8_t saros_number) { return { saros_number }; }
+
+/** std::views::take, so a query reads as one pipeline */
+inline constexpr auto take = std::views::take;
+
+template <class K, class S>
+constexpr catalog_view<K, S> operator|(const catalog_view<K, S> &v, detail::in_range_fn f)
+{
+    return v.in_range(f.t0, f.t1);
+}
+
+template <class K, class S>
+constexpr query_view<K, S> operator|(const query_view<K, S> &q, detail::in_range_fn f)
+{
+    return q.in_range(f.t0, f.t1);
+}
+
+template <class K, class S>
+constexpr query_view<K, S> operator|(const query_view<K, S> &q, detail::of_type_fn f)
+{
+    return q.of_type(f.type_mask);
+}
+
+template <class K, class S>
+constexpr query_view<K, S> operator|(const query_view<K, S> &q, detail::in_series_fn f)
+{
+    return q.in_series(f.saros_number);
+}
+
+template <class K, class S>
+constexpr query_view<K, S> operator|(const catalog_view<K, S> &v, detail::of_type_fn f)
+{
+    return query_view<K, S>(v).of_type(f.type_mask);
+}
+
+template <class K, class S>
+constexpr query_view<K, S> operator|(const catalog_view<K, S> &v, detail::in_series_fn f)
+{
+    return query_view<K, S>(v).in_series(f.saros_number);
+}
+
+/* ── Build-time checks ──────────────────────────────────────────────────── */
+
+namespace detail {
+
+/* The C API indexes with uint16_t global indices and 0xFFFF for none */
+template <class K, class S>
+constexpr bool fits_index(const dataset<K, S> &)
+{
+    return dataset<K, S>::count < link_none;
+}
+
+template <class K, class S>
+constexpr bool sorted(const dataset<K, S> &d)
+{
+    return std::is_sorted(d.times.begin(), d.times.end());
+}
+
+/* Every eclipse in exactly one series, its own, in time order, and the
+ * prev / next links those of the series order. */
+template <class K, class S>
+constexpr bool series_consistent(const dataset<K, S> &d)
+{
+    using D = dataset<K, S>;
+    if (D::saros_last < D::saros_first || D::saros_last - D::saros_first + 1u != D::series)
+        return false;
+    if (d.saros_offsets[0] != 0u || d.saros_offsets[D::series] != D::count)
+        return false;
+
+    std::array<bool, D::count> seen{};
+    for (std::size_t s = 0; s < D::series; s++) {
+        uint32_t begin = d.saros_offsets[s], end = d.saros_offsets[s + 1];
+        if (end < begin)
+            return false;
+        for (uint32_t k = begin; k < end; k++) {
+            uint16_t m = d.saros_members[k];
+            if (m >= D::count || seen[m] || d.info[m].saros_number != D::saros_first + s)
+                return false;
+            seen[m] = true;
+            uint16_t prev = k > begin    ? d.saros_members[k - 1] : link_none;
+            uint16_t next = k + 1u < end ? d.saros_members[k + 1] : link_none;
+            if (d.prev_in_series[m] != prev || d.next_in_series[m] != next)
+                return false;
+            if (prev != link_none && d.times[prev] >= d.times[m])
+                return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace detail
+
+/* ── Generated datasets ─────────────────────────────────────────────────── */
+
+#define _SAROS_HPP_DATASET(k, K, s, S)                                             \
+    template <>                                                                    \
+    struct slice_traits<k##_kind, s##_slice> {                                     \
+        static constexpr std::size_t    count       = K##_ECLIPSE_##S##_COUNT;     \
+        static constexpr std::size_t    series      = K##_ECLIPSE_##S##_SAROS_COUNT; \
+        static constexpr uint8_t        saros_first = K##_ECLIPSE_##S##_SAROS_FIRST; \
+        static constexpr uint8_t        saros_last  = K##_ECLIPSE_##S##_SAROS_LAST; \
+        static constexpr const uint8_t *times       = k##_eclipse_times_##s;       \
+        static constexpr const uint8_t *info        = k##_eclipse_info_##s;        \
+        static constexpr const uint8_t *offsets     = k##_saros_offsets_##s;       \
+        static constexpr const uint8_t *members     = k##_saros_members_##s;       \
+        static constexpr const uint8_t *prev        = k##_prev_in_series_##s;      \
+        static constexpr const uint8_t *next        = k##_next_in_series_##s;      \
+    };                                                                             \
+    inline constexpr const dataset<k##_kind, s##_slice> &k##_##s =                 \
+        catalog<k##_kind, s##_slice>;                                              \
+    static_assert(detail::fits_index(k##_##s),                                     \
+                  #k "_" #s ": too many eclipses for 16-bit indices");             \
+    static_assert(detail::sorted(k##_##s),                                         \
+                  #k "_" #s ": timestamps out of order");                          \
+    static_assert(detail::series_consistent(k##_##s),                              \
+                  #k "_" #s ": series index or links inconsistent")
+
+#if defined(SOLAR_ECLIPSE_TIMES_MODERN_H) && defined(SOLAR_ECLIPSE_INFO_MODERN_H) && \
+    defined(SOLAR_SAROS_MODERN_H)
+_SAROS_HPP_DATASET(solar, SOLAR, modern, MODERN);
+#endif
+#if defined(SOLAR_ECLIPSE_TIMES_ALL_H) && defined(SOLAR_ECLIPSE_INFO_ALL_H) && \
+    defined(SOLAR_SAROS_ALL_H)
+_SAROS_HPP_DATASET(solar, SOLAR, all, ALL);
+#endif
+#if defined(LUNAR_ECLIPSE_TIMES_MODERN_H) && defined(LUNAR_ECLIPSE_INFO_MODERN_H) && \
+    defined(LUNAR_SAROS_MODERN_H)
+_SAROS_HPP_DATASET(lunar, LUNAR, modern, MODERN);
+#endif
+#if defined(LUNAR_ECLIPSE_TIMES_ALL_H) && defined(LUNAR_ECLIPSE_INFO_ALL_H) && \
+    defined(LUNAR_SAROS_ALL_H)
+_SAROS_HPP_DATASET(lunar, LUNAR, all, ALL);
+#endif
+
+#undef _SAROS_HPP_DATASET
+
+}  // namespace saros
+
+/* The views only point into the datasets, so their iterators outlive them */
+template <class K, class S>
+inline constexpr bool std::ranges::enable_borrowed_range<saros::catalog_view<K, S>> = true;
+template <class K, class S>
+inline constexpr bool std::ranges::enable_borrowed_range<saros::query_view<K, S>> = true;
+
+#endif /* SAROS_HPP */
@@ -1,15 +1,49 @@
 /*
  * solar_impl.c — Solar eclipse implementation translation unit.
  *
- * Compile with lunar_impl.c and test_saros_lib.c (or your own main).
+ * Compile with lunar_impl.c, timeline_impl.c and test_saros_lib.c (or your
+ * own main), or use saros_impl.c instead of all three.
  * Optionally define SAROS_USE_ALL to use the full Saros 1-180 dataset.
  * Optionally define ECLIPSE_USE_PROGMEM on AVR/ESP32.
+ * Optionally define SAROS_LAYOUT_EYTZINGER to search the Eytzinger copy, or
+ * SAROS_USE_BUCKET_INDEX to narrow the binary search with the bucket table.
+ * Optionally define SAROS_PACKED_TIMES to keep the timestamps compressed.
+ * Optionally define SAROS_PACKED_INFO to read the bit-packed info records, or
+ * SAROS_INFO_COLUMNS to read the column-split ones.
+ * Optionally define SAROS_USE_CLASS_INDEX to speed up the type-filtered calls.
+ * Optionally define SAROS_USE_DURATION_INDEX to speed up the *_min_duration calls.
+ * Optionally define SAROS_USE_GEO_INDEX to build find_solar_eclipses_near() (link -lm).
  */
 
 #define SAROS_IMPL_SOLAR
 /* #define SAROS_USE_ALL */
 
+#ifdef SAROS_PACKED_TIMES
+#include "solar/eclipse_times_packed_modern.h"
+#else
 #include "solar/eclipse_times_modern.h"
+#endif
+#ifdef SAROS_PACKED_INFO
+#include "solar/eclipse_info_packed_modern.h"
+#elif defined(SAROS_INFO_COLUMNS)
+#include "solar/eclipse_info_columns_modern.h"
+#else
 #include "solar/eclipse_info_modern.h"
+#endif
 #include "solar/saros_modern.h"
+#ifdef SAROS_LAYOUT_EYTZINGER
+#include "solar/eclipse_eytz_modern.h"
+#endif
+#ifdef SAROS_USE_BUCKET_INDEX
+#include "solar/eclipse_bucket_modern.h"
+#endif
+#ifdef SAROS_USE_CLASS_INDEX
+#include "solar/eclipse_class_modern.h"
+#endif
+#ifdef SAROS_USE_DURATION_INDEX
+#include "solar/eclipse_dmax_modern.h"
+#endif
+#ifdef SAROS_USE_GEO_INDEX
+#include "solar/eclipse_geo_modern.h"
+#endif
 #include "saros.h"
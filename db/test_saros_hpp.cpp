@@ -0,0 +1,219 @@
+/*
+ * test_saros_hpp.cpp — saros.hpp against the C API
+ *
+ * The constexpr lookups must fold at compile time (the static_asserts below)
+ * and agree at run time with saros_find_*() on the ctx_impl.c handle of the
+ * same dataset.  Build with:  make test_saros_hpp
+ */
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "solar/eclipse_times_modern.h"
+#include "solar/eclipse_info_modern.h"
+#include "solar/saros_modern.h"
+#include "solar/eclipse_times_all.h"
+#include "solar/eclipse_info_all.h"
+#include "solar/saros_all.h"
+#include "lunar/eclipse_times_modern.h"
+#include "lunar/eclipse_info_modern.h"
+#include "lunar/saros_modern.h"
+#include "lunar/eclipse_times_all.h"
+#include "lunar/eclipse_info_all.h"
+#include "lunar/saros_all.h"
+#include "saros.hpp"
+
+/* ── Compile-time lookups ───────────────────────────────────────────────── */
+
+template <class D>
+constexpr bool folds(const D &d)
+{
+    constexpr uint32_t last = D::count - 1u;
+    eclipse_result_t first = saros::next_eclipse(d, INT64_MIN);
+    eclipse_result_t final = saros::past_eclipse(d, INT64_MAX);
+    eclipse_result_t mid   = saros::closest_eclipse(d, d.times[D::count / 2u]);
+    saros_window_t   w     = saros::saros_window(d, d.times[D::count / 2u],
+                                                 d.info[D::count / 2u].saros_number);
+    return first.eclipse.valid && first.eclipse.global_index == 0u &&
+           final.eclipse.valid && final.eclipse.global_index == last &&
+           !saros::next_eclipse(d, d.times[last] + 1).eclipse.valid &&
+           !saros::past_eclipse(d, d.times[0] - 1).eclipse.valid &&
+           mid.eclipse.unix_time == d.times[D::count / 2u] &&
+           w.future.valid && w.future.unix_time == d.times[D::count / 2u] &&
+           (!w.past.valid || w.past.unix_time < w.future.unix_time) &&
+           !saros::saros_window(d, 0, (uint8_t)(d.saros_last + 1u)).future.valid;
+}
+
+static_assert(folds(saros::solar_modern));
+static_assert(folds(saros::solar_all));
+static_assert(folds(saros::lunar_modern));
+static_assert(folds(saros::lunar_all));
+static_assert(saros::solar_all.count > saros::solar_modern.count);
+
+/* The engine directly, and the policy constants */
+using solar_modern_engine = saros::engine<saros::solar_kind, saros::modern_slice>;
+static_assert(solar_modern_engine::next(saros::solar_modern, INT64_MIN).eclipse.global_index == 0u);
+static_assert(solar_modern_engine::count == SOLAR_ECLIPSE_MODERN_COUNT);
+static_assert(saros::lunar_all.saros_first == LUNAR_ECLIPSE_ALL_SAROS_FIRST);
+static_assert(saros::next_eclipse_of(saros::lunar_modern, INT64_MIN, saros::lunar_kind::total)
+                  .eclipse.info.lunar.total_duration != 0xFFFFu);
+static_assert(!saros::next_eclipse_of(saros::solar_modern, INT64_MIN, 0u).eclipse.valid);
+
+/* ── Views ──────────────────────────────────────────────────────────────── */
+
+using solar_view = saros::catalog_view<saros::solar_kind, saros::modern_slice>;
+using solar_query = saros::query_view<saros::solar_kind, saros::modern_slice>;
+static_assert(std::ranges::random_access_range<solar_view>);
+static_assert(std::ranges::sized_range<solar_view>);
+static_assert(std::ranges::view<solar_view> && std::ranges::borrowed_range<solar_view>);
+static_assert(std::ranges::forward_range<solar_query> && std::ranges::view<solar_query>);
+static_assert(std::ranges::borrowed_range<solar_query>);
+
+/* A pipeline against the loop it stands for, both at compile time */
+template <class K, class S>
+constexpr bool pipeline_is_loop(const saros::dataset<K, S> &d, int64_t t0, int64_t t1,
+                                uint32_t type_mask, uint8_t saros_number, std::size_t n)
+{
+    auto q = saros::eclipses(d) | saros::in_range(t0, t1) | saros::of_type(type_mask) |
+             saros::in_series(saros_number) | saros::take(n);
+    auto it = std::ranges::begin(q);
+    std::size_t seen = 0;
+    for (uint32_t i = 0; i < d.count && seen < n; i++) {
+        if (d.times[i] < t0 || d.times[i] >= t1 || d.info[i].saros_number != saros_number ||
+            !((type_mask >> d.info[i].ecl_type) & 1u))
+            continue;
+        if (it == std::ranges::end(q) || (*it).global_index != i || (*it).unix_time != d.times[i])
+            return false;
+        ++it;
+        seen++;
+    }
+    return it == std::ranges::end(q);
+}
+
+static_assert(pipeline_is_loop(saros::solar_modern, INT64_MIN, INT64_MAX,
+                               saros::solar_kind::total, 145, 10));
+static_assert(pipeline_is_loop(saros::lunar_modern, 0, 2000000000,
+                               saros::lunar_kind::all_types, 130, 1000));
+static_assert(std::ranges::size(saros::solar() | saros::in_range(INT64_MIN, INT64_MAX)) ==
+              SOLAR_ECLIPSE_MODERN_COUNT);
+static_assert(saros::solar<saros::all_slice>().times().size() == SOLAR_ECLIPSE_ALL_COUNT);
+
+/* ── Run time: the same answers as the C API ────────────────────────────── */
+
+static bool same(const eclipse_entry_t &a, const eclipse_entry_t &b, eclipse_kind_t kind)
+{
+    if (a.valid != b.valid)
+        return false;
+    if (!a.valid)
+        return true;
+    if (a.unix_time != b.unix_time || a.global_index != b.global_index)
+        return false;
+    if (kind == ECLIPSE_KIND_LUNAR) {
+        const lunar_eclipse_info_t &x = a.info.lunar, &y = b.info.lunar;
+        return x.pen_duration == y.pen_duration && x.par_duration == y.par_duration &&
+               x.total_duration == y.total_duration && x.saros_number == y.saros_number &&
+               x.saros_pos == y.saros_pos && x.ecl_type == y.ecl_type;
+    }
+    const solar_eclipse_info_t &x = a.info.solar, &y = b.info.solar;
+    return x.latitude_deg10 == y.latitude_deg10 && x.longitude_deg10 == y.longitude_deg10 &&
+           x.central_duration == y.central_duration && x.saros_number == y.saros_number &&
+           x.saros_pos == y.saros_pos && x.ecl_type == y.ecl_type && x.sun_alt == y.sun_alt;
+}
+
+static bool same(const eclipse_result_t &a, const eclipse_result_t &b, eclipse_kind_t kind)
+{
+    return same(a.eclipse, b.eclipse, kind) && same(a.saros_prev, b.saros_prev, kind) &&
+           same(a.saros_next, b.saros_next, kind);
+}
+
+template <class D>
+static int check(const char *name, const D &d, const saros_ctx_t *ctx)
+{
+    const eclipse_kind_t kind = D::kind;
+    int bad = ctx->kind != kind || ctx->count != D::count ||
+              ctx->saros_first != d.saros_first || ctx->saros_last != d.saros_last;
+
+    for (uint32_t idx = 0; idx < D::count && !bad; idx++) {
+        int64_t t = d.times[idx];
+        for (int64_t ts : { t - 1, t, t + 1 }) {
+            bad |= !same(saros::next_eclipse(d, ts),    saros_find_next(ctx, ts), kind);
+            bad |= !same(saros::past_eclipse(d, ts),    saros_find_past(ctx, ts), kind);
+            bad |= !same(saros::closest_eclipse(d, ts), saros_find_closest(ctx, ts), kind);
+        }
+        bad |= !same(saros::result(d, idx), saros_result(ctx, idx), kind);
+    }
+    for (int64_t ts : { INT64_MIN, (int64_t)0, INT64_MAX }) {
+        bad |= !same(saros::next_eclipse(d, ts),    saros_find_next(ctx, ts), kind);
+        bad |= !same(saros::past_eclipse(d, ts),    saros_find_past(ctx, ts), kind);
+        bad |= !same(saros::closest_eclipse(d, ts), saros_find_closest(ctx, ts), kind);
+    }
+    const uint32_t masks[] = { D::kind_type::all_types, D::kind_type::partial,
+                               D::kind_type::total, 0x7u, 0u };
+    const uint16_t secs[]  = { 0, 60, 240, 3600, 0xFFFEu, 0xFFFFu };
+    for (uint32_t idx = 0; idx < D::count && !bad; idx += D::count / 200u + 1u) {
+        int64_t t = d.times[idx];
+        for (uint32_t m : masks) {
+            bad |= !same(saros::next_eclipse_of(d, t, m), saros_find_next_of(ctx, t, m), kind);
+            bad |= !same(saros::past_eclipse_of(d, t, m), saros_find_past_of(ctx, t, m), kind);
+        }
+        for (uint16_t sec : secs)
+            for (lunar_phase_t ph : { LUNAR_PHASE_PENUMBRAL, LUNAR_PHASE_PARTIAL,
+                                      LUNAR_PHASE_TOTAL }) {
+                bad |= !same(saros::next_eclipse_min_duration(d, t, ph, sec),
+                             saros_find_next_min_duration(ctx, t, ph, sec), kind);
+                bad |= !same(saros::past_eclipse_min_duration(d, t, ph, sec),
+                             saros_find_past_min_duration(ctx, t, ph, sec), kind);
+            }
+        for (unsigned sn = 0; sn <= 181u; sn++) {
+            saros_window_t w = saros::saros_window(d, d.times[idx], (uint8_t)sn);
+            saros_window_t c = saros_find_window(ctx, d.times[idx], (uint8_t)sn);
+            bad |= w.saros_number != c.saros_number || !same(w.past, c.past, kind) ||
+                   !same(w.future, c.future, kind);
+        }
+    }
+    /* views against C ranges filtered by hand; each query both ways */
+    const int64_t t0 = d.times[D::count / 3u], t1 = d.times[2u * D::count / 3u];
+    for (uint32_t m : masks)
+        for (unsigned sn : { 0u, (unsigned)d.info[D::count / 2u].saros_number, 181u }) {
+            auto all = saros::eclipses(d) | saros::in_range(t0, t1) | saros::of_type(m);
+            auto v   = sn ? all | saros::in_series((uint8_t)sn) : all;
+            auto it  = v.begin();
+            eclipse_range_t r = saros_range(ctx, t0, t1);
+            while (!bad && saros_range_next_of(ctx, &r, m)) {
+                eclipse_entry_t e = saros_entry(ctx, r.index);
+                uint8_t series = kind == ECLIPSE_KIND_LUNAR ? e.info.lunar.saros_number
+                                                            : e.info.solar.saros_number;
+                if (sn && series != sn)
+                    continue;
+                bad |= it == v.end() || it.index() != r.index || !same(*it, e, kind) ||
+                       !same(it.result(), saros_result(ctx, r.index), kind);
+                ++it;
+            }
+            bad |= it != v.end();
+        }
+    auto whole = saros::eclipses(d) | saros::in_range(t0, t1);
+    for (std::size_t k = 0; k < whole.size() && !bad; k += whole.size() / 50u + 1u)
+        bad |= !same(whole[k], saros_entry(ctx, whole.first() + (uint32_t)k), kind) ||
+               whole.times()[k] != saros_time(ctx, whole.first() + (uint32_t)k);
+
+    std::printf("  %-12s %5zu eclipses, Saros %u-%u: %s\n", name, D::count,
+                d.saros_first, d.saros_last, bad ? "MISMATCH" : "ok");
+    return bad;
+}
+
+int main(void)
+{
+    constexpr int64_t ts_2024 = 1712000000;   /* a constant query, folded */
+    constexpr eclipse_result_t r = saros::next_eclipse(saros::solar_modern, ts_2024);
+    std::printf("next solar eclipse after %" PRId64 ": %" PRId64 " (Saros %u)\n\n",
+                ts_2024, r.eclipse.unix_time, r.eclipse.info.solar.saros_number);
+
+    int bad = 0;
+    std::printf("saros.hpp vs saros_find_*():\n");
+    bad |= check("solar_modern", saros::solar_modern, &saros_ctx_solar_modern);
+    bad |= check("solar_all",    saros::solar_all,    &saros_ctx_solar_all);
+    bad |= check("lunar_modern", saros::lunar_modern, &saros_ctx_lunar_modern);
+    bad |= check("lunar_all",    saros::lunar_all,    &saros_ctx_lunar_all);
+    std::printf("saros.hpp vs saros_find_*(): %s\n", bad ? "MISMATCH" : "ok");
+    return bad;
+}
@@ -4,14 +4,21 @@
  * Build (from db/):
  *   make test_saros_lib
  * or manually:
- *   cc -O2 -Wall -std=c11 -o test_saros_lib \
- *       test_saros_lib.c solar_impl.c lunar_impl.c
+ *   cc -O2 -Wall -std=c11 -pthread -o test_saros_lib \
+ *       test_saros_lib.c saros_impl.c db_impl.c -lm
  */
 
+#define _POSIX_C_SOURCE 200809L   /* nanosleep */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <math.h>
+#include <time.h>
 
 #include "saros.h"
 
@@ -143,6 +150,562 @@ static void print_lunar_window(const char *title, const saros_window_t *w)
     printf("\n");
 }
 
+/* ── find_solar_eclipses_near() collector ───────────────────────────────── */
+
+typedef struct {
+    uint32_t idx[65536];
+    double   km[65536];
+    uint32_t n;
+    uint32_t stop_after;       /* 0 = never stop */
+} near_hits_t;
+
+static int collect_near(uint32_t idx, double distance_km, void *user)
+{
+    near_hits_t *h = (near_hits_t *)user;
+    h->idx[h->n]  = idx;
+    h->km[h->n++] = distance_km;
+    return h->stop_after != 0 && h->n >= h->stop_after;
+}
+
+/* Haversine distance in km, computed independently of saros.h */
+static double test_distance_km(double lat1, double lon1, double lat2, double lon2)
+{
+    const double rad = 3.14159265358979323846 / 180.0;
+    double a = pow(sin((lat2 - lat1) * rad / 2), 2) +
+               cos(lat1 * rad) * cos(lat2 * rad) * pow(sin((lon2 - lon1) * rad / 2), 2);
+    return 2 * SAROS_EARTH_RADIUS_KM * asin(sqrt(a < 1 ? a : 1));
+}
+
+/* ── Runtime .db helpers ────────────────────────────────────────────────── */
+
+static eclipse_result_t find_next_solar_min(int64_t ts, lunar_phase_t phase, uint16_t secs)
+{
+    (void)phase;
+    return find_next_solar_eclipse_min_duration(ts, secs);
+}
+
+static eclipse_result_t find_past_solar_min(int64_t ts, lunar_phase_t phase, uint16_t secs)
+{
+    (void)phase;
+    return find_past_solar_eclipse_min_duration(ts, secs);
+}
+
+/* The compiled-in API of one kind, so the .db checks can loop over both. */
+typedef struct {
+    eclipse_kind_t   kind;
+    const char      *name;
+    uint32_t         types;                       /* every type bit of the kind */
+    eclipse_result_t (*next)(int64_t);
+    eclipse_result_t (*past)(int64_t);
+    eclipse_result_t (*closest)(int64_t);
+    eclipse_result_t (*next_of)(int64_t, uint32_t);
+    eclipse_result_t (*past_of)(int64_t, uint32_t);
+    eclipse_result_t (*next_min)(int64_t, lunar_phase_t, uint16_t);
+    eclipse_result_t (*past_min)(int64_t, lunar_phase_t, uint16_t);
+    saros_window_t   (*window)(int64_t, uint8_t);
+    eclipse_range_t  (*range)(int64_t, int64_t);
+    int              (*range_next)(eclipse_range_t *);
+    eclipse_result_t (*result)(uint32_t);
+} compiled_api_t;
+
+static const compiled_api_t COMPILED[] = {
+    { ECLIPSE_KIND_SOLAR, "solar",
+      SOLAR_TYPES_ANNULAR | SOLAR_TYPES_HYBRID | SOLAR_TYPES_PARTIAL | SOLAR_TYPES_TOTAL,
+      find_next_solar_eclipse, find_past_solar_eclipse, find_closest_solar_eclipse,
+      find_next_solar_eclipse_of, find_past_solar_eclipse_of,
+      find_next_solar_min, find_past_solar_min, find_solar_saros_window,
+      solar_eclipse_range, solar_range_next, saros_solar_result },
+    { ECLIPSE_KIND_LUNAR, "lunar",
+      LUNAR_TYPES_PENUMBRAL | LUNAR_TYPES_PARTIAL | LUNAR_TYPES_TOTAL,
+      find_next_lunar_eclipse, find_past_lunar_eclipse, find_closest_lunar_eclipse,
+      find_next_lunar_eclipse_of, find_past_lunar_eclipse_of,
+      find_next_lunar_eclipse_min_duration, find_past_lunar_eclipse_min_duration,
+      find_lunar_saros_window, lunar_eclipse_range, lunar_range_next, saros_lunar_result },
+};
+
+/* A result with its global indices cleared, for comparing across datasets. */
+static eclipse_result_t without_indices(eclipse_result_t r)
+{
+    r.eclipse.global_index = r.saros_prev.global_index = r.saros_next.global_index = 0;
+    return r;
+}
+
+/* Duration of the eclipse in the given phase (solar: central duration). */
+static uint16_t entry_duration(const eclipse_entry_t *e, eclipse_kind_t kind,
+                               lunar_phase_t phase)
+{
+    if (kind == ECLIPSE_KIND_SOLAR)
+        return e->info.solar.central_duration;
+    return phase == LUNAR_PHASE_PENUMBRAL ? e->info.lunar.pen_duration
+         : phase == LUNAR_PHASE_PARTIAL   ? e->info.lunar.par_duration
+                                          : e->info.lunar.total_duration;
+}
+
+static uint8_t entry_saros(const eclipse_entry_t *e, eclipse_kind_t kind)
+{
+    return kind == ECLIPSE_KIND_SOLAR ? e->info.solar.saros_number
+                                      : e->info.lunar.saros_number;
+}
+
+/*
+ * Checks the saros_db_*() lookups against scans of the files, and the files
+ * against the compiled-in data; returns nonzero on a mismatch.  fixed[] are
+ * the reference timestamps, and [t0, t1) a window for the range checks.
+ */
+static int check_runtime_db(const saros_db_t *db, const int64_t *fixed, size_t nfixed,
+                            int64_t t0, int64_t t1)
+{
+    static int64_t probes[256];
+    static eclipse_result_t batch[256];
+    const uint16_t secs[] = { 0, 60, 240, 3600, 0xFFFEu };
+    errno = 0;
+    int bad = saros_db_open("no-such-dir") != NULL || errno != ENOENT;
+    for (size_t k = 0; k < sizeof(COMPILED) / sizeof(COMPILED[0]); k++) {
+        const compiled_api_t *c = &COMPILED[k];
+        eclipse_kind_t kind = c->kind;
+        uint32_t n = saros_db_count(db, kind);
+
+        /* every compiled eclipse is in the files, in the same order, with
+         * the same record and Saros neighbours */
+        uint32_t compiled = 0, at = 0;
+        eclipse_range_t r = c->range(INT64_MIN, INT64_MAX);
+        while (c->range_next(&r)) {
+            eclipse_result_t want = without_indices(c->result(r.index));
+            for (;; at++) {
+                if (at >= n) {
+                    bad = 1;
+                    break;
+                }
+                eclipse_result_t got = without_indices(saros_db_result(db, kind, at));
+                if (memcmp(&want, &got, sizeof(got)) == 0)
+                    break;
+            }
+            at++;
+            compiled++;
+        }
+        printf("  %s: %u eclipses in the files, %u compiled in\n", c->name, n, compiled);
+
+        size_t np = 0;
+        for (size_t i = 0; i < nfixed; i++)
+            probes[np++] = fixed[i];
+        for (uint32_t i = 0; i < n && np + 3u <= 256u; i += n / 80u + 1u) {
+            int64_t t = saros_db_time(db, kind, i);
+            probes[np++] = t - 1;
+            probes[np++] = t;
+            probes[np++] = t + 1;
+        }
+
+        for (size_t i = 0; i < np; i++) {
+            int64_t ts = probes[i];
+            uint32_t below = 0, upto = 0;
+            for (uint32_t j = 0; j < n; j++) {
+                below += saros_db_time(db, kind, j) < ts;
+                upto  += saros_db_time(db, kind, j) <= ts;
+            }
+            uint32_t next = saros_db_next_index(db, kind, ts);
+            uint32_t past = saros_db_past_index(db, kind, ts);
+            uint32_t near = saros_db_closest_index(db, kind, ts);
+            bad |= next != (below < n ? below : SAROS_NO_ECLIPSE);
+            bad |= past != (upto > 0u ? upto - 1u : SAROS_NO_ECLIPSE);
+            bad |= near != next && near != past;
+            if (next != SAROS_NO_ECLIPSE && past != SAROS_NO_ECLIPSE) {
+                int64_t d_next = saros_db_time(db, kind, next) - ts;
+                int64_t d_past = ts - saros_db_time(db, kind, past);
+                bad |= near != (d_past < d_next ? past : next);
+            }
+
+            eclipse_result_t none, want, got;
+            memset(&none, 0, sizeof(none));
+            want = next != SAROS_NO_ECLIPSE ? saros_db_result(db, kind, next) : none;
+            got  = saros_db_find_next(db, kind, ts);
+            bad |= memcmp(&want, &got, sizeof(got)) != 0;
+            want = past != SAROS_NO_ECLIPSE ? saros_db_result(db, kind, past) : none;
+            got  = saros_db_find_past(db, kind, ts);
+            bad |= memcmp(&want, &got, sizeof(got)) != 0;
+            want = near != SAROS_NO_ECLIPSE ? saros_db_result(db, kind, near) : none;
+            got  = saros_db_find_closest(db, kind, ts);
+            bad |= memcmp(&want, &got, sizeof(got)) != 0;
+
+            /* filters: the first / last match around the probe */
+            const uint32_t masks[] = { c->types, 0x7u, 0x1C00u, 0u };
+            for (size_t m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+                uint32_t j = below;
+                while (j < n && !(SAROS_TYPE_BIT(saros_db_type(db, kind, j)) & masks[m]))
+                    j++;
+                want = j < n ? saros_db_result(db, kind, j) : none;
+                got  = saros_db_find_next_of(db, kind, ts, masks[m]);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                j = upto;
+                while (j > 0u && !(SAROS_TYPE_BIT(saros_db_type(db, kind, j - 1u)) & masks[m]))
+                    j--;
+                want = j > 0u ? saros_db_result(db, kind, j - 1u) : none;
+                got  = saros_db_find_past_of(db, kind, ts, masks[m]);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+            }
+            for (int phase = LUNAR_PHASE_PENUMBRAL; phase <= LUNAR_PHASE_TOTAL; phase++) {
+                for (size_t d = 0; d < sizeof(secs) / sizeof(secs[0]); d++) {
+                    uint32_t j = below;
+                    for (; j < n; j++) {
+                        eclipse_entry_t e = saros_db_entry(db, kind, j);
+                        uint16_t dur = entry_duration(&e, kind, (lunar_phase_t)phase);
+                        if (dur != 0xFFFFu && dur >= secs[d])
+                            break;
+                    }
+                    want = j < n ? saros_db_result(db, kind, j) : none;
+                    got  = saros_db_find_next_min_duration(db, kind, ts,
+                                                           (lunar_phase_t)phase, secs[d]);
+                    bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                    for (j = upto; j > 0u; j--) {
+                        eclipse_entry_t e = saros_db_entry(db, kind, j - 1u);
+                        uint16_t dur = entry_duration(&e, kind, (lunar_phase_t)phase);
+                        if (dur != 0xFFFFu && dur >= secs[d])
+                            break;
+                    }
+                    want = j > 0u ? saros_db_result(db, kind, j - 1u) : none;
+                    got  = saros_db_find_past_min_duration(db, kind, ts,
+                                                           (lunar_phase_t)phase, secs[d]);
+                    bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                }
+            }
+        }
+
+        /* Saros windows against a scan of the series */
+        const uint8_t series[] = { 0, 1, 120, 139, 145, 180, 181 };
+        for (size_t i = 0; i < nfixed; i++) {
+            for (size_t sn = 0; sn < sizeof(series) / sizeof(series[0]); sn++) {
+                saros_window_t want, got;
+                memset(&want, 0, sizeof(want));
+                want.saros_number = series[sn];
+                for (uint32_t j = 0; j < n; j++) {
+                    eclipse_entry_t e = saros_db_entry(db, kind, j);
+                    if (entry_saros(&e, kind) != series[sn])
+                        continue;
+                    if (e.unix_time < fixed[i])
+                        want.past = e;
+                    else if (!want.future.valid)
+                        want.future = e;
+                }
+                got = saros_db_saros_window(db, kind, fixed[i], series[sn]);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+            }
+        }
+
+        /* batches: the sampled probes alone are sorted, with fixed[] in front not */
+        for (int sorted = 0; sorted < 2; sorted++) {
+            const int64_t *in = sorted ? probes + nfixed : probes;
+            size_t m = sorted ? np - nfixed : np;
+            saros_db_find_next_batch(db, kind, in, m, batch);
+            for (size_t i = 0; i < m; i++) {
+                eclipse_result_t want = saros_db_find_next(db, kind, in[i]);
+                bad |= memcmp(&want, &batch[i], sizeof(want)) != 0;
+            }
+            saros_db_find_past_batch(db, kind, in, m, batch);
+            for (size_t i = 0; i < m; i++) {
+                eclipse_result_t want = saros_db_find_past(db, kind, in[i]);
+                bad |= memcmp(&want, &batch[i], sizeof(want)) != 0;
+            }
+        }
+
+        /* ranges, plain and filtered */
+        eclipse_range_t all = saros_db_range(db, kind, t0, t1);
+        eclipse_range_t of  = saros_db_range(db, kind, t0, t1);
+        uint32_t in_range = 0;
+        while (saros_db_range_next(&all)) {
+            int64_t t = saros_db_time(db, kind, all.index);
+            bad |= t < t0 || t > t1 - 1;
+            in_range++;
+            if (SAROS_TYPE_BIT(saros_db_type(db, kind, all.index)) & 0x1C00u)
+                bad |= !saros_db_range_next_of(db, kind, &of, 0x1C00u) ||
+                       of.index != all.index;
+        }
+        bad |= saros_db_range_next_of(db, kind, &of, 0x1C00u);
+        bad |= in_range != saros_db_next_index(db, kind, t1) -
+                           saros_db_next_index(db, kind, t0);
+        all = saros_db_range(db, kind, t1 - 1, t0);
+        bad |= saros_db_range_next(&all);
+
+        /* with the whole catalog compiled in, both must answer alike */
+        if (compiled == n) {
+            for (size_t i = 0; i < np; i++) {
+                eclipse_result_t want = c->next(probes[i]);
+                eclipse_result_t got  = saros_db_find_next(db, kind, probes[i]);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                want = c->past(probes[i]);
+                got  = saros_db_find_past(db, kind, probes[i]);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                want = c->closest(probes[i]);
+                got  = saros_db_find_closest(db, kind, probes[i]);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                want = c->next_of(probes[i], 0x7u);
+                got  = saros_db_find_next_of(db, kind, probes[i], 0x7u);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                want = c->past_of(probes[i], 0x7u);
+                got  = saros_db_find_past_of(db, kind, probes[i], 0x7u);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                want = c->next_min(probes[i], LUNAR_PHASE_PARTIAL, 240);
+                got  = saros_db_find_next_min_duration(db, kind, probes[i],
+                                                       LUNAR_PHASE_PARTIAL, 240);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                want = c->past_min(probes[i], LUNAR_PHASE_PARTIAL, 240);
+                got  = saros_db_find_past_min_duration(db, kind, probes[i],
+                                                       LUNAR_PHASE_PARTIAL, 240);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                saros_window_t w_want = c->window(probes[i], 145);
+                saros_window_t w_got  = saros_db_saros_window(db, kind, probes[i], 145);
+                bad |= memcmp(&w_want, &w_got, sizeof(w_got)) != 0;
+            }
+        }
+    }
+
+    /* spatial lookup against the same distance test as the compiled one; with
+     * a grid the hits come cell by cell, so they are checked as a set */
+    {
+        static near_hits_t hits;
+        static uint8_t seen[65536];
+        hits.n = 0;
+        hits.stop_after = 0;
+        uint32_t calls = saros_db_find_solar_near(db, 64.8, -147.7, 1500.0,
+                                                  -2208988800LL, 4102444800LL,
+                                                  collect_near, &hits);
+        uint32_t inside = 0;
+        bad |= calls != hits.n;
+        memset(seen, 0, sizeof(seen));
+        for (uint32_t h = 0; h < hits.n; h++) {
+            eclipse_entry_t e = saros_db_entry(db, ECLIPSE_KIND_SOLAR, hits.idx[h]);
+            double km = test_distance_km(64.8, -147.7,
+                                         e.info.solar.latitude_deg10 / 10.0,
+                                         e.info.solar.longitude_deg10 / 10.0);
+            bad |= seen[hits.idx[h]]++ != 0;
+            bad |= e.unix_time < -2208988800LL || e.unix_time >= 4102444800LL;
+            bad |= km > 1500.0 + 1e-6 || fabs(km - hits.km[h]) > 1e-6;
+        }
+        eclipse_range_t r = saros_db_range(db, ECLIPSE_KIND_SOLAR,
+                                           -2208988800LL, 4102444800LL);
+        while (saros_db_range_next(&r)) {
+            eclipse_entry_t e = saros_db_entry(db, ECLIPSE_KIND_SOLAR, r.index);
+            double km = test_distance_km(64.8, -147.7,
+                                         e.info.solar.latitude_deg10 / 10.0,
+                                         e.info.solar.longitude_deg10 / 10.0);
+            if (km <= 1500.0 - 1e-6) {
+                bad |= !seen[r.index];
+                inside++;
+            }
+        }
+        bad |= inside > calls;
+        printf("  solar near Fairbanks, 1900-2100: %u eclipses\n", calls);
+    }
+    return bad;
+}
+
+/* CRC32C as build_db.py writes it, bit by bit, independently of saros.h */
+static uint32_t test_crc32c(const uint8_t *p, size_t n)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    while (n--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++)
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+}
+
+/* Recomputes the header CRC of a container image whose section table was
+ * edited: the header with its CRC field zeroed, then the table. */
+static void test_reseal(uint8_t *image, uint32_t sections)
+{
+    memset(image + 24, 0, 4);
+    uint32_t crc = test_crc32c(image, 64u + sections * 32u);
+    for (int b = 0; b < 4; b++)
+        image[24 + b] = (uint8_t)(crc >> (8 * b));
+}
+
+/* Writes image to path; nonzero on success. */
+static int test_write(const char *path, const uint8_t *image, size_t len)
+{
+    FILE *out = fopen(path, "wb");
+    int ok = out && fwrite(image, 1, len, out) == len;
+    if (out && fclose(out) != 0)
+        ok = 0;
+    return ok;
+}
+
+/* ── Context-handle helpers ─────────────────────────────────────────────── */
+
+/* The exported dataset of c's kind holding as many eclipses as the build. */
+static const saros_ctx_t *compiled_ctx(const compiled_api_t *c)
+{
+    const saros_ctx_t *both[2][2] = {
+        { &saros_ctx_solar_modern, &saros_ctx_solar_all },
+        { &saros_ctx_lunar_modern, &saros_ctx_lunar_all },
+    };
+    const saros_ctx_t *const *k = both[c->kind == ECLIPSE_KIND_LUNAR];
+    return k[0]->count == c->range(INT64_MIN, INT64_MAX).end ? k[0] : k[1];
+}
+
+/* find_solar_eclipses_near() is only built with SAROS_USE_GEO_INDEX; other
+ * builds ask the solar handle of the same dataset, which reports the same
+ * eclipses at the same distances. */
+static uint32_t test_near(double lat, double lon, double radius_km,
+                          int64_t t0, int64_t t1, solar_near_fn cb, void *user)
+{
+#ifdef SAROS_USE_GEO_INDEX
+    return find_solar_eclipses_near(lat, lon, radius_km, t0, t1, cb, user);
+#else
+    return saros_find_near(compiled_ctx(&COMPILED[0]), lat, lon, radius_km, t0, t1, cb, user);
+#endif
+}
+
+/*
+ * Checks the saros_find_*(ctx) calls against the compiled-in ones of the
+ * same dataset, which must agree exactly; returns nonzero on a mismatch.
+ */
+static int check_ctx(const saros_ctx_t *ctx, const compiled_api_t *c,
+                     const int64_t *fixed, size_t nfixed)
+{
+    static int64_t probes[256];
+    static eclipse_result_t want[256], got[256];
+    const uint16_t secs[] = { 0, 60, 240, 3600, 0xFFFEu };
+    const uint32_t masks[] = { c->types, 0x7u, 0x1C00u, 0u };
+    uint32_t n = ctx->count;
+    int bad = ctx->kind != c->kind;
+
+    for (uint32_t idx = 0; idx < n; idx++) {
+        eclipse_result_t w = c->result(idx), g = saros_result(ctx, idx);
+        bad |= memcmp(&w, &g, sizeof(g)) != 0;
+    }
+
+    size_t np = 0;
+    for (size_t i = 0; i < nfixed; i++)
+        probes[np++] = fixed[i];
+    for (uint32_t i = 0; i < n && np + 3u <= 256u; i += n / 80u + 1u) {
+        int64_t t = saros_time(ctx, i);
+        probes[np++] = t - 1;
+        probes[np++] = t;
+        probes[np++] = t + 1;
+    }
+    for (size_t i = 0; i < np; i++) {
+        eclipse_result_t w, g;
+        int64_t t = probes[i];
+#define SAME(a, b) (w = (a), g = (b), memcmp(&w, &g, sizeof(g)) == 0)
+        bad |= !SAME(c->next(t),    saros_find_next(ctx, t));
+        bad |= !SAME(c->past(t),    saros_find_past(ctx, t));
+        bad |= !SAME(c->closest(t), saros_find_closest(ctx, t));
+        for (size_t m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+            bad |= !SAME(c->next_of(t, masks[m]), saros_find_next_of(ctx, t, masks[m]));
+            bad |= !SAME(c->past_of(t, masks[m]), saros_find_past_of(ctx, t, masks[m]));
+        }
+        for (size_t k = 0; k < sizeof(secs) / sizeof(secs[0]); k++)
+            for (int ph = LUNAR_PHASE_PENUMBRAL; ph <= LUNAR_PHASE_TOTAL; ph++) {
+                lunar_phase_t phase = (lunar_phase_t)ph;
+                bad |= !SAME(c->next_min(t, phase, secs[k]),
+                             saros_find_next_min_duration(ctx, t, phase, secs[k]));
+                bad |= !SAME(c->past_min(t, phase, secs[k]),
+                             saros_find_past_min_duration(ctx, t, phase, secs[k]));
+            }
+#undef SAME
+        for (uint32_t sn = 0; sn <= 181u; sn += 7u) {
+            saros_window_t ww = c->window(t, (uint8_t)sn);
+            saros_window_t gw = saros_find_window(ctx, t, (uint8_t)sn);
+            bad |= memcmp(&ww, &gw, sizeof(gw)) != 0;
+        }
+        want[i] = c->next(t);
+    }
+    saros_find_next_batch(ctx, probes, np, got);
+    bad |= memcmp(want, got, np * sizeof(got[0])) != 0;
+    for (size_t i = 0; i < np; i++)
+        want[i] = c->past(probes[i]);
+    saros_find_past_batch(ctx, probes, np, got);
+    bad |= memcmp(want, got, np * sizeof(got[0])) != 0;
+
+    /* type-filtered ranges over the whole dataset */
+    for (size_t m = 0; m < sizeof(masks) / sizeof(masks[0]); m++) {
+        eclipse_range_t w = c->range(INT64_MIN, INT64_MAX);
+        eclipse_range_t r = saros_range(ctx, INT64_MIN, INT64_MAX);
+        for (;;) {
+            int more;
+            while ((more = c->range_next(&w)) &&
+                   !((masks[m] >> saros_type(ctx, w.index)) & 1u))
+                ;
+            if (more != saros_range_next_of(ctx, &r, masks[m]) ||
+                (more && w.index != r.index)) {
+                bad = 1;
+                break;
+            }
+            if (!more)
+                break;
+        }
+    }
+
+    /* the same eclipses near a point, in whatever order */
+    if (ctx->kind == ECLIPSE_KIND_SOLAR) {
+        static near_hits_t hits;
+        static uint8_t seen[65536];
+        const double q[][3] = { { 64.8, -147.7, 1500.0 }, { -89.5, 45.0, 1200.0 },
+                                { 10.0, 179.5, 3000.0 } };
+        for (size_t i = 0; i < sizeof(q) / sizeof(q[0]); i++) {
+            hits.n = 0;
+            hits.stop_after = 0;
+            uint32_t want = test_near(q[i][0], q[i][1], q[i][2],
+                                      INT64_MIN, INT64_MAX,
+                                      collect_near, &hits);
+            memset(seen, 0, sizeof(seen));
+            for (uint32_t h = 0; h < hits.n; h++)
+                seen[hits.idx[h]] = 1;
+            hits.n = 0;
+            bad |= saros_find_near(ctx, q[i][0], q[i][1], q[i][2], INT64_MIN, INT64_MAX,
+                                   collect_near, &hits) != want;
+            for (uint32_t h = 0; h < hits.n; h++)
+                bad |= seen[hits.idx[h]]-- != 1;
+        }
+    } else {
+        bad |= saros_find_near(ctx, 0.0, 0.0, 25000.0, INT64_MIN, INT64_MAX,
+                               collect_near, NULL) != 0;
+    }
+    return bad;
+}
+
+/* ── Hot-swap helpers ───────────────────────────────────────────────────── */
+
+typedef struct {
+    saros_db_live_t        *live;
+    const int64_t          *probes;
+    const eclipse_result_t *want;      /* saros_db_find_next(solar) per probe */
+    size_t                  n;
+    atomic_int             *stop;
+    uint64_t                reads;
+    int                     bad;
+} live_reader_t;
+
+static void *live_reader(void *arg)
+{
+    live_reader_t *r = (live_reader_t *)arg;
+    for (size_t i = 0; !atomic_load(r->stop); i = (i + 1u) % r->n) {
+        uint32_t ticket;
+        const saros_db_t *db = saros_db_live_acquire(r->live, &ticket);
+        eclipse_result_t got = saros_db_find_next(db, ECLIPSE_KIND_SOLAR, r->probes[i]);
+        r->bad |= memcmp(&got, &r->want[i], sizeof(got)) != 0;
+        r->bad |= saros_db_count(db, ECLIPSE_KIND_LUNAR) == 0u;
+        saros_db_live_release(r->live, ticket);
+        r->reads++;
+    }
+    return NULL;
+}
+
+typedef struct {
+    saros_db_live_t *live;
+    const char      *path;
+    atomic_int       done;
+    int              rc;
+} live_swap_t;
+
+static void *live_swapper(void *arg)
+{
+    live_swap_t *s = (live_swap_t *)arg;
+    s->rc = saros_db_live_swap(s->live, saros_db_open(s->path));
+    atomic_store(&s->done, 1);
+    return NULL;
+}
+
 /* ── Tests ──────────────────────────────────────────────────────────────── */
 
 int main(void)
@@ -231,5 +794,771 @@ int main(void)
         print_lunar_window("find_lunar_saros_window(1970-01-01, saros=110):", &w2);
     }
 
+    printf("═══════════════════════════════════════════════════════════════\n\n");
+
+    /* ── Cache: hits must match a fresh search ──────────────────────────── */
+    {
+        eclipse_result_t r = find_next_solar_eclipse(ts_2024_solar);
+        int64_t t = r.eclipse.unix_time;
+        const int64_t probes[] = { t - 1, t, t + 1, t, t - 1 };
+        int bad = 0;
+        for (size_t i = 0; i < sizeof(probes) / sizeof(probes[0]); i++) {
+            eclipse_result_t nc = find_next_solar_eclipse(probes[i]);
+            eclipse_result_t pc = find_past_solar_eclipse(probes[i]);
+            solar_invalidate_cache();
+            eclipse_result_t nf = find_next_solar_eclipse(probes[i]);
+            solar_invalidate_cache();
+            eclipse_result_t pf = find_past_solar_eclipse(probes[i]);
+            bad |= memcmp(&nc, &nf, sizeof(nc)) != 0;
+            bad |= memcmp(&pc, &pf, sizeof(pc)) != 0;
+        }
+        for (size_t i = 0; i < sizeof(probes) / sizeof(probes[0]); i++) {
+            eclipse_result_t nc = find_next_lunar_eclipse(probes[i]);
+            lunar_invalidate_cache();
+            eclipse_result_t nf = find_next_lunar_eclipse(probes[i]);
+            bad |= memcmp(&nc, &nf, sizeof(nc)) != 0;
+        }
+        printf("cache consistency around solar eclipse boundary: %s\n\n",
+               bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Batch: sorted merge walk and unsorted fallback match single calls ─ */
+    {
+        enum { N = 99 };   /* not a multiple of 8: the last group is partial */
+        int64_t ts[N];
+        eclipse_result_t out[N];
+        int bad = 0;
+        /* every ~3 weeks from 2020 on; several land on the same eclipse */
+        for (int i = 0; i < N; i++)
+            ts[i] = ts_2024_solar - 4 * 31557600LL + (int64_t)i * 1814400LL;
+
+        for (int pass = 0; pass < 2; pass++) {
+            memset(out, 0xA5, sizeof(out));   /* a slot left unwritten mismatches */
+            find_next_solar_eclipse_batch(ts, N, out);
+            for (int i = 0; i < N; i++) {
+                eclipse_result_t r = find_next_solar_eclipse(ts[i]);
+                bad |= memcmp(&r, &out[i], sizeof(r)) != 0;
+            }
+            memset(out, 0xA5, sizeof(out));
+            find_past_solar_eclipse_batch(ts, N, out);
+            for (int i = 0; i < N; i++) {
+                eclipse_result_t r = find_past_solar_eclipse(ts[i]);
+                bad |= memcmp(&r, &out[i], sizeof(r)) != 0;
+            }
+            memset(out, 0xA5, sizeof(out));
+            find_next_lunar_eclipse_batch(ts, N, out);
+            for (int i = 0; i < N; i++) {
+                eclipse_result_t r = find_next_lunar_eclipse(ts[i]);
+                bad |= memcmp(&r, &out[i], sizeof(r)) != 0;
+            }
+            memset(out, 0xA5, sizeof(out));
+            find_past_lunar_eclipse_batch(ts, N, out);
+            for (int i = 0; i < N; i++) {
+                eclipse_result_t r = find_past_lunar_eclipse(ts[i]);
+                bad |= memcmp(&r, &out[i], sizeof(r)) != 0;
+            }
+            /* second pass: reversed, i.e. unsorted input */
+            for (int i = 0; i < N / 2; i++) {
+                int64_t t = ts[i];
+                ts[i] = ts[N - 1 - i];
+                ts[N - 1 - i] = t;
+            }
+        }
+        printf("batch lookups (sorted + unsorted) vs single calls: %s\n\n",
+               bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Closest: single search matches the nearer of next / past ───────── */
+    {
+        eclipse_result_t a = find_next_solar_eclipse(ts_2024_solar);
+        eclipse_result_t b = find_next_solar_eclipse(a.eclipse.unix_time + 1);
+        int64_t ta = a.eclipse.unix_time, tb = b.eclipse.unix_time;
+        int64_t mid = ta + (tb - ta + 1) / 2;
+        /* both sides of the midpoint, repeated so the cache is hit too */
+        const int64_t probes[] = { ta - 1, ta, ta + 1, mid - 1, mid, mid + 1,
+                                   mid - 1, mid, tb, INT64_MIN, INT64_MAX };
+        int bad = 0;
+        for (size_t i = 0; i < sizeof(probes) / sizeof(probes[0]); i++) {
+            int64_t t = probes[i];
+            for (int lunar = 0; lunar < 2; lunar++) {
+                eclipse_result_t nxt = lunar ? find_next_lunar_eclipse(t)
+                                             : find_next_solar_eclipse(t);
+                eclipse_result_t pst = lunar ? find_past_lunar_eclipse(t)
+                                             : find_past_solar_eclipse(t);
+                eclipse_result_t want = nxt;
+                if (!nxt.eclipse.valid ||
+                    (pst.eclipse.valid &&
+                     t - pst.eclipse.unix_time < nxt.eclipse.unix_time - t))
+                    want = pst;
+                eclipse_result_t got = lunar ? find_closest_lunar_eclipse(t)
+                                             : find_closest_solar_eclipse(t);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+            }
+        }
+        printf("closest lookups vs nearer of next/past: %s\n\n",
+               bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Handles: index API agrees with the full results ────────────────── */
+    {
+        const int64_t probes[] = { INT64_MIN, ts_epoch, ts_2024_solar,
+                                   ts_2024_solar + 1, INT64_MAX };
+        int bad = 0;
+        for (size_t i = 0; i < sizeof(probes) / sizeof(probes[0]); i++) {
+            eclipse_result_t rs[3] = {
+                find_next_solar_eclipse(probes[i]),
+                find_past_solar_eclipse(probes[i]),
+                find_closest_solar_eclipse(probes[i]),
+            };
+            uint32_t hs[3] = {
+                find_next_solar_index(probes[i]),
+                find_past_solar_index(probes[i]),
+                find_closest_solar_index(probes[i]),
+            };
+            for (int k = 0; k < 3; k++) {
+                const eclipse_result_t *r = &rs[k];
+                uint32_t h = hs[k], prev, next;
+                if (!r->eclipse.valid) {
+                    bad |= h != SAROS_NO_ECLIPSE;
+                    continue;
+                }
+                solar_eclipse_info_t info = saros_solar_info(h);
+                eclipse_result_t full = saros_solar_result(h);
+                saros_solar_neighbours(h, &prev, &next);
+                bad |= memcmp(&full, r, sizeof(full)) != 0;
+                bad |= h != r->eclipse.global_index;
+                bad |= saros_solar_time(h) != r->eclipse.unix_time;
+                bad |= saros_solar_type(h) != r->eclipse.info.solar.ecl_type;
+                bad |= memcmp(&info, &r->eclipse.info.solar, sizeof(info)) != 0;
+                bad |= r->saros_prev.valid ? prev != r->saros_prev.global_index
+                                           : prev != SAROS_NO_ECLIPSE;
+                bad |= r->saros_next.valid ? next != r->saros_next.global_index
+                                           : next != SAROS_NO_ECLIPSE;
+            }
+
+            eclipse_result_t lr = find_next_lunar_eclipse(probes[i]);
+            uint32_t lh = find_next_lunar_index(probes[i]);
+            if (!lr.eclipse.valid) {
+                bad |= lh != SAROS_NO_ECLIPSE;
+            } else {
+                uint32_t prev, next;
+                eclipse_result_t full = saros_lunar_result(lh);
+                saros_lunar_neighbours(lh, &prev, &next);
+                bad |= memcmp(&full, &lr, sizeof(full)) != 0;
+                bad |= saros_lunar_time(lh) != lr.eclipse.unix_time;
+                bad |= saros_lunar_type(lh) != lr.eclipse.info.lunar.ecl_type;
+                bad |= lr.saros_next.valid ? next != lr.saros_next.global_index
+                                           : next != SAROS_NO_ECLIPSE;
+            }
+        }
+        printf("index handles vs full results: %s\n\n", bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Range: iterator visits the same eclipses as chained find_next ──── */
+    {
+        int64_t t0 = ts_epoch, t1 = ts_epoch + 100 * 31557600LL;
+        int bad = 0, n = 0;
+        eclipse_range_t r = solar_eclipse_range(t0, t1);
+        eclipse_result_t f = find_next_solar_eclipse(t0);
+        while (solar_range_next(&r)) {
+            eclipse_entry_t e = solar_range_entry(&r);
+            solar_eclipse_info_t info = solar_range_info(&r);
+            bad |= memcmp(&e, &f.eclipse, sizeof(e)) != 0;
+            bad |= solar_range_time(&r) != e.unix_time;
+            bad |= memcmp(&info, &e.info.solar, sizeof(info)) != 0;
+            f = find_next_solar_eclipse(e.unix_time + 1);
+            n++;
+        }
+        bad |= f.eclipse.valid && f.eclipse.unix_time < t1;
+
+        eclipse_range_t lr = lunar_eclipse_range(t0, t1);
+        eclipse_result_t lf = find_next_lunar_eclipse(t0);
+        while (lunar_range_next(&lr)) {
+            bad |= lunar_range_time(&lr) != lf.eclipse.unix_time;
+            lf = find_next_lunar_eclipse(lunar_range_time(&lr) + 1);
+        }
+        bad |= lf.eclipse.valid && lf.eclipse.unix_time < t1;
+
+        eclipse_range_t empty = solar_eclipse_range(t1, t0);
+        bad |= solar_range_next(&empty);
+        printf("range iterator over 1970-2070 (%d solar eclipses) vs find_next: %s\n\n",
+               n, bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Filtered range: next_of matches range_next plus a type test ────── */
+    {
+        const uint32_t solar_masks[] = {
+            SAROS_TYPE_BIT(SOLAR_ECL_T), SAROS_TYPE_BIT(SOLAR_ECL_Ts),
+            SAROS_TYPE_BIT(SOLAR_ECL_A) | SAROS_TYPE_BIT(SOLAR_ECL_H) |
+                SAROS_TYPE_BIT(SOLAR_ECL_Tplus),
+            0u, UINT32_MAX,
+        };
+        const uint32_t lunar_masks[] = {
+            SAROS_TYPE_BIT(LUNAR_ECL_T), SAROS_TYPE_BIT(LUNAR_ECL_Nb),
+            0u, UINT32_MAX,
+        };
+        int bad = 0, n = 0;
+        for (size_t m = 0; m < sizeof(solar_masks) / sizeof(solar_masks[0]); m++) {
+            eclipse_range_t all = solar_eclipse_range(INT64_MIN, INT64_MAX);
+            eclipse_range_t of  = all;
+            while (solar_range_next(&all)) {
+                if (!(solar_masks[m] & SAROS_TYPE_BIT(saros_solar_type(all.index))))
+                    continue;
+                bad |= !solar_range_next_of(&of, solar_masks[m]);
+                bad |= of.index != all.index;
+                n++;
+            }
+            bad |= solar_range_next_of(&of, solar_masks[m]);
+        }
+        for (size_t m = 0; m < sizeof(lunar_masks) / sizeof(lunar_masks[0]); m++) {
+            eclipse_range_t all = lunar_eclipse_range(INT64_MIN, INT64_MAX);
+            eclipse_range_t of  = all;
+            while (lunar_range_next(&all)) {
+                if (!(lunar_masks[m] & SAROS_TYPE_BIT(saros_lunar_type(all.index))))
+                    continue;
+                bad |= !lunar_range_next_of(&of, lunar_masks[m]);
+                bad |= of.index != all.index;
+                n++;
+            }
+            bad |= lunar_range_next_of(&of, lunar_masks[m]);
+        }
+        /* sub-ranges with unaligned ends, the mask changing between steps and
+         * plain steps mixed in: next_of keeps per-range state */
+        uint32_t count = find_past_solar_index(INT64_MAX) + 1u;
+        for (uint32_t k = 0; k < 40u && !bad; k++) {
+            uint32_t a = (7u + 613u * k) % (count - 200u), b = a + 37u + (29u * k) % 150u;
+            eclipse_range_t of = solar_eclipse_range(saros_solar_time(a), saros_solar_time(b));
+            for (uint32_t step = 0, idx = a;; step++, idx++) {
+                uint32_t mask = solar_masks[step % 3u];
+                int more;
+                if (step % 5u == 4u) {
+                    more = solar_range_next(&of);
+                } else {
+                    while (idx < b && !(mask & SAROS_TYPE_BIT(saros_solar_type(idx))))
+                        idx++;
+                    more = solar_range_next_of(&of, mask);
+                }
+                bad |= more != (idx < b) || (more && of.index != idx);
+                if (!more || bad)
+                    break;
+            }
+        }
+        printf("type-filtered range over the whole catalog (%d matches) vs type test: %s\n\n",
+               n, bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Type-filtered lookups: same as stepping find_next/past by hand ─── */
+    {
+        const uint32_t solar_masks[] = {
+            SOLAR_TYPES_TOTAL, SOLAR_TYPES_HYBRID, SAROS_TYPE_BIT(SOLAR_ECL_Tplus),
+            SOLAR_TYPES_ANNULAR | SAROS_TYPE_BIT(SOLAR_ECL_Pb), 0u,
+        };
+        const uint32_t lunar_masks[] = {
+            LUNAR_TYPES_TOTAL, LUNAR_TYPES_PARTIAL | LUNAR_TYPES_TOTAL,
+            SAROS_TYPE_BIT(LUNAR_ECL_Nx),
+        };
+        const int64_t probes[] = { INT64_MIN, ts_epoch, ts_2024_solar,
+                                   ts_2024_solar + 1, INT64_MAX };
+        int bad = 0;
+        for (size_t i = 0; i < sizeof(probes) / sizeof(probes[0]); i++) {
+            for (size_t m = 0; m < sizeof(solar_masks) / sizeof(solar_masks[0]); m++) {
+                uint32_t mask = solar_masks[m];
+                eclipse_result_t want = find_next_solar_eclipse(probes[i]);
+                while (want.eclipse.valid &&
+                       !(mask & SAROS_TYPE_BIT(want.eclipse.info.solar.ecl_type)))
+                    want = find_next_solar_eclipse(want.eclipse.unix_time + 1);
+                eclipse_result_t got = find_next_solar_eclipse_of(probes[i], mask);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+
+                want = find_past_solar_eclipse(probes[i]);
+                while (want.eclipse.valid &&
+                       !(mask & SAROS_TYPE_BIT(want.eclipse.info.solar.ecl_type)))
+                    want = find_past_solar_eclipse(want.eclipse.unix_time - 1);
+                got = find_past_solar_eclipse_of(probes[i], mask);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+            }
+            for (size_t m = 0; m < sizeof(lunar_masks) / sizeof(lunar_masks[0]); m++) {
+                uint32_t mask = lunar_masks[m];
+                eclipse_result_t want = find_next_lunar_eclipse(probes[i]);
+                while (want.eclipse.valid &&
+                       !(mask & SAROS_TYPE_BIT(want.eclipse.info.lunar.ecl_type)))
+                    want = find_next_lunar_eclipse(want.eclipse.unix_time + 1);
+                eclipse_result_t got = find_next_lunar_eclipse_of(probes[i], mask);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+
+                want = find_past_lunar_eclipse(probes[i]);
+                while (want.eclipse.valid &&
+                       !(mask & SAROS_TYPE_BIT(want.eclipse.info.lunar.ecl_type)))
+                    want = find_past_lunar_eclipse(want.eclipse.unix_time - 1);
+                got = find_past_lunar_eclipse_of(probes[i], mask);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+            }
+        }
+        printf("type-filtered lookups vs stepping find_next/past: %s\n\n",
+               bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Duration thresholds: same as stepping find_next/past by hand ──── */
+    {
+        const uint16_t solar_secs[] = { 0u, 1u, 240u, 420u, 0xFFFEu };
+        const uint16_t lunar_secs[] = { 0u, 3600u, 5400u, 0xFFFEu };
+        const int64_t probes[] = { INT64_MIN, ts_epoch, ts_2024_solar, INT64_MAX };
+        int bad = 0;
+        for (size_t i = 0; i < sizeof(probes) / sizeof(probes[0]); i++) {
+            for (size_t d = 0; d < sizeof(solar_secs) / sizeof(solar_secs[0]); d++) {
+                uint16_t secs = solar_secs[d];
+                eclipse_result_t want = find_next_solar_eclipse(probes[i]);
+                while (want.eclipse.valid &&
+                       (want.eclipse.info.solar.central_duration == 0xFFFFu ||
+                        want.eclipse.info.solar.central_duration < secs))
+                    want = find_next_solar_eclipse(want.eclipse.unix_time + 1);
+                eclipse_result_t got = find_next_solar_eclipse_min_duration(probes[i], secs);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+
+                want = find_past_solar_eclipse(probes[i]);
+                while (want.eclipse.valid &&
+                       (want.eclipse.info.solar.central_duration == 0xFFFFu ||
+                        want.eclipse.info.solar.central_duration < secs))
+                    want = find_past_solar_eclipse(want.eclipse.unix_time - 1);
+                got = find_past_solar_eclipse_min_duration(probes[i], secs);
+                bad |= memcmp(&want, &got, sizeof(got)) != 0;
+            }
+            for (int phase = LUNAR_PHASE_PENUMBRAL; phase <= LUNAR_PHASE_TOTAL; phase++) {
+                for (size_t d = 0; d < sizeof(lunar_secs) / sizeof(lunar_secs[0]); d++) {
+                    uint16_t secs = lunar_secs[d];
+                    eclipse_result_t want = find_next_lunar_eclipse(probes[i]);
+                    for (;;) {
+                        const lunar_eclipse_info_t *li = &want.eclipse.info.lunar;
+                        uint16_t dur = phase == LUNAR_PHASE_PENUMBRAL ? li->pen_duration
+                                     : phase == LUNAR_PHASE_PARTIAL   ? li->par_duration
+                                                                      : li->total_duration;
+                        if (!want.eclipse.valid || (dur != 0xFFFFu && dur >= secs))
+                            break;
+                        want = find_next_lunar_eclipse(want.eclipse.unix_time + 1);
+                    }
+                    eclipse_result_t got = find_next_lunar_eclipse_min_duration(
+                        probes[i], (lunar_phase_t)phase, secs);
+                    bad |= memcmp(&want, &got, sizeof(got)) != 0;
+
+                    want = find_past_lunar_eclipse(probes[i]);
+                    for (;;) {
+                        const lunar_eclipse_info_t *li = &want.eclipse.info.lunar;
+                        uint16_t dur = phase == LUNAR_PHASE_PENUMBRAL ? li->pen_duration
+                                     : phase == LUNAR_PHASE_PARTIAL   ? li->par_duration
+                                                                      : li->total_duration;
+                        if (!want.eclipse.valid || (dur != 0xFFFFu && dur >= secs))
+                            break;
+                        want = find_past_lunar_eclipse(want.eclipse.unix_time - 1);
+                    }
+                    got = find_past_lunar_eclipse_min_duration(
+                        probes[i], (lunar_phase_t)phase, secs);
+                    bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                }
+            }
+        }
+        printf("duration-threshold lookups vs stepping find_next/past: %s\n\n",
+               bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Spatial lookups: same set as a distance test over the range ───── */
+    {
+        static near_hits_t hits;
+        static uint8_t seen[65536];
+        const struct { double lat, lon, km; int64_t t0, t1; } q[] = {
+            {  64.8, -147.7,  1500.0, -2208988800LL, 4102444800LL },  /* Fairbanks, 1900-2100 */
+            {  51.5,   -0.1,   800.0, INT64_MIN, INT64_MAX },
+            {   0.0,    0.0,  2000.0, INT64_MIN, INT64_MAX },
+            { -89.5,   45.0,  1200.0, INT64_MIN, INT64_MAX },        /* circle over the pole */
+            {  10.0,  179.5,  3000.0, ts_epoch, ts_2024_solar },     /* across the date line */
+            {  30.0,   60.0,     0.0, INT64_MIN, INT64_MAX },
+            { -20.0,  -70.0, 25000.0, ts_epoch, ts_2024_solar + 1 }, /* whole globe */
+        };
+        int bad = 0;
+        printf("solar eclipses near a point vs distance test:\n");
+        for (size_t i = 0; i < sizeof(q) / sizeof(q[0]); i++) {
+            hits.n = 0;
+            hits.stop_after = 0;
+            uint32_t calls = test_near(q[i].lat, q[i].lon, q[i].km, q[i].t0, q[i].t1,
+                                       collect_near, &hits);
+            bad |= calls != hits.n;
+            memset(seen, 0, sizeof(seen));
+            for (uint32_t h = 0; h < hits.n; h++) {
+                solar_eclipse_info_t si = saros_solar_info(hits.idx[h]);
+                int64_t t = saros_solar_time(hits.idx[h]);
+                double km = test_distance_km(q[i].lat, q[i].lon,
+                                             si.latitude_deg10 / 10.0,
+                                             si.longitude_deg10 / 10.0);
+                bad |= seen[hits.idx[h]]++ != 0;
+                bad |= t < q[i].t0 || t >= q[i].t1;
+                bad |= fabs(km - hits.km[h]) > 1e-6 || hits.km[h] > q[i].km + 1e-6;
+            }
+            uint32_t inside = 0;
+            eclipse_range_t r = solar_eclipse_range(q[i].t0, q[i].t1);
+            while (solar_range_next(&r)) {
+                solar_eclipse_info_t si = solar_range_info(&r);
+                double km = test_distance_km(q[i].lat, q[i].lon,
+                                             si.latitude_deg10 / 10.0,
+                                             si.longitude_deg10 / 10.0);
+                if (km <= q[i].km - 1e-6) {
+                    bad |= !seen[r.index];
+                    inside++;
+                }
+            }
+            printf("  %6.1f %6.1f  r=%7.1f km  %4u eclipses\n",
+                   q[i].lat, q[i].lon, q[i].km, calls);
+            bad |= inside > calls;
+
+            hits.n = 0;
+            hits.stop_after = 1;
+            uint32_t first = test_near(q[i].lat, q[i].lon, q[i].km, q[i].t0, q[i].t1,
+                                       collect_near, &hits);
+            bad |= first != (calls > 0u) || hits.n != first;
+        }
+        bad |= test_near(0.0, 0.0, 25000.0, ts_2024_solar, ts_epoch,
+                         collect_near, &hits) != 0;
+
+        /* a point off the globe finds nothing, and longitudes wrap */
+        hits.n = 0;
+        hits.stop_after = 0;
+        bad |= test_near(NAN, 0.0, 2000.0, INT64_MIN, INT64_MAX, collect_near, &hits) != 0;
+        bad |= test_near(0.0, NAN, 2000.0, INT64_MIN, INT64_MAX, collect_near, &hits) != 0;
+        bad |= test_near(0.0, INFINITY, 2000.0, INT64_MIN, INT64_MAX, collect_near, &hits) != 0;
+        bad |= test_near(-INFINITY, 0.0, 2000.0, INT64_MIN, INT64_MAX, collect_near, &hits) != 0;
+        bad |= test_near(90.5, 0.0, 2000.0, INT64_MIN, INT64_MAX, collect_near, &hits) != 0;
+        bad |= test_near(0.0, 0.0, NAN, INT64_MIN, INT64_MAX, collect_near, &hits) != 0;
+        bad |= hits.n != 0;
+        const double wrap[][2] = { { -80.0, 1e12 }, { -180.0, 540.0 }, { 179.5, -180.5 } };
+        for (size_t i = 0; i < sizeof(wrap) / sizeof(wrap[0]); i++) {
+            hits.n = 0;
+            uint32_t want = test_near(10.0, wrap[i][0], 3000.0, INT64_MIN, INT64_MAX,
+                                      collect_near, &hits);
+            hits.n = 0;
+            bad |= test_near(10.0, wrap[i][1], 3000.0, INT64_MIN, INT64_MAX,
+                             collect_near, &hits) != want;
+        }
+        printf("solar eclipses near a point vs distance test: %s\n\n",
+               bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Solar + lunar: merged lookups vs the per-kind ones ─────────────── */
+    {
+        const int64_t probes[] = { INT64_MIN, ts_epoch, ts_2010_solar, ts_2024_solar,
+                                   ts_2024_solar + 1, ts_2025_lunar, INT64_MAX };
+        int bad = 0;
+        printf("merged solar + lunar vs per-kind lookups:\n");
+        for (size_t i = 0; i < sizeof(probes) / sizeof(probes[0]); i++) {
+            eclipse_result_t s = find_next_solar_eclipse(probes[i]);
+            eclipse_result_t l = find_next_lunar_eclipse(probes[i]);
+            eclipse_any_result_t a = find_next_eclipse_any(probes[i]);
+            int lunar = l.eclipse.valid &&
+                        (!s.eclipse.valid || l.eclipse.unix_time < s.eclipse.unix_time);
+            bad |= a.kind != (lunar ? ECLIPSE_KIND_LUNAR : ECLIPSE_KIND_SOLAR);
+            bad |= memcmp(&a.result, lunar ? &l : &s, sizeof(a.result)) != 0;
+
+            s = find_past_solar_eclipse(probes[i]);
+            l = find_past_lunar_eclipse(probes[i]);
+            a = find_past_eclipse_any(probes[i]);
+            lunar = l.eclipse.valid &&
+                    (!s.eclipse.valid || l.eclipse.unix_time > s.eclipse.unix_time);
+            bad |= a.kind != (lunar ? ECLIPSE_KIND_LUNAR : ECLIPSE_KIND_SOLAR);
+            bad |= memcmp(&a.result, lunar ? &l : &s, sizeof(a.result)) != 0;
+        }
+
+        const struct { int64_t t0, t1; } w[] = {
+            { ts_epoch, ts_2024_solar + 1 },
+            { ts_2024_solar, ts_2024_solar + 1 },
+            { ts_2024_solar + 1, ts_2024_solar },
+            { INT64_MIN, INT64_MAX },
+        };
+        for (size_t i = 0; i < sizeof(w) / sizeof(w[0]); i++) {
+            eclipse_timeline_t tl = eclipse_timeline(w[i].t0, w[i].t1);
+            eclipse_range_t rs = solar_eclipse_range(w[i].t0, w[i].t1);
+            eclipse_range_t rl = lunar_eclipse_range(w[i].t0, w[i].t1);
+            int ls = solar_range_next(&rs), ll = lunar_range_next(&rl);
+            uint32_t n_solar = 0, n_lunar = 0;
+            while (eclipse_timeline_next(&tl)) {
+                int lunar = ll && (!ls || lunar_range_time(&rl) < solar_range_time(&rs));
+                eclipse_entry_t want, got = eclipse_timeline_entry(&tl);
+                if (!ls && !ll) {
+                    bad = 1;
+                    break;
+                }
+                if (lunar) {
+                    want = lunar_range_entry(&rl);
+                    bad |= tl.kind != ECLIPSE_KIND_LUNAR || tl.index != rl.index;
+                    ll = lunar_range_next(&rl);
+                    n_lunar++;
+                } else {
+                    want = solar_range_entry(&rs);
+                    bad |= tl.kind != ECLIPSE_KIND_SOLAR || tl.index != rs.index;
+                    ls = solar_range_next(&rs);
+                    n_solar++;
+                }
+                bad |= tl.time != want.unix_time;
+                bad |= memcmp(&got, &want, sizeof(got)) != 0;
+            }
+            bad |= ls || ll || eclipse_timeline_next(&tl);
+            printf("  timeline window %zu: %u solar + %u lunar\n", i, n_solar, n_lunar);
+        }
+        printf("merged solar + lunar vs per-kind lookups: %s\n\n",
+               bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Runtime datasets vs the compiled-in data ──────────────────────── */
+    {
+        const int64_t fixed[] = { INT64_MIN, ts_epoch, ts_2010_solar, ts_2024_solar,
+                                  ts_2025_lunar, INT64_MAX };
+        const struct { const char *path, *name; } src[] = {
+            { ".",            "runtime .db files" },
+            { "eclipses.sdb", "runtime container" },
+        };
+        for (size_t i = 0; i < sizeof(src) / sizeof(src[0]); i++) {
+            saros_db_t *db = saros_db_open(src[i].path);
+            if (!db) {
+                printf("%s: not found (%s), skipped\n\n", src[i].name, strerror(errno));
+                continue;
+            }
+            printf("%s vs compiled-in data:\n", src[i].name);
+            int bad = check_runtime_db(db, fixed, sizeof(fixed) / sizeof(fixed[0]),
+                                       ts_epoch, ts_2024_solar + 1);
+            saros_db_close(db);
+            printf("%s vs compiled-in data: %s\n\n", src[i].name, bad ? "MISMATCH" : "ok");
+            if (bad)
+                return 1;
+        }
+    }
+
+    /* ── Context handles vs the compiled-in calls ──────────────────────── */
+    {
+        const int64_t fixed[] = { INT64_MIN, ts_epoch, ts_2010_solar, ts_2024_solar,
+                                  ts_2025_lunar, INT64_MAX };
+        int bad = 0;
+        printf("context handles vs compiled-in calls:\n");
+        for (size_t k = 0; k < sizeof(COMPILED) / sizeof(COMPILED[0]); k++) {
+            const saros_ctx_t *ctx = compiled_ctx(&COMPILED[k]);
+            int b = check_ctx(ctx, &COMPILED[k], fixed, sizeof(fixed) / sizeof(fixed[0]));
+            printf("  %s: %u eclipses, Saros %u-%u: %s\n", COMPILED[k].name, ctx->count,
+                   ctx->saros_first, ctx->saros_last, b ? "MISMATCH" : "ok");
+            bad |= b;
+        }
+
+        /* the full datasets are the ones the .db files hold */
+        saros_db_t *db = saros_db_open(".");
+        if (db) {
+            const saros_ctx_t *all[] = { &saros_ctx_solar_all, &saros_ctx_lunar_all };
+            for (size_t k = 0; k < 2; k++) {
+                uint8_t first, last;
+                uint32_t n = saros_db_count(db, all[k]->kind);
+                saros_db_saros_range(db, all[k]->kind, &first, &last);
+                bad |= n != all[k]->count;
+                bad |= first != all[k]->saros_first || last != all[k]->saros_last;
+                for (uint32_t idx = 0; idx < n && idx < all[k]->count; idx++) {
+                    eclipse_result_t want = saros_db_result(db, all[k]->kind, idx);
+                    eclipse_result_t got  = saros_result(all[k], idx);
+                    bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                }
+            }
+            saros_db_close(db);
+        }
+        printf("context handles vs compiled-in calls: %s\n\n", bad ? "MISMATCH" : "ok");
+        if (bad)
+            return 1;
+    }
+
+    /* ── Container: same data as the .db files, damage is refused ───────── */
+    {
+        saros_db_t *files = saros_db_open(".");
+        saros_db_t *sdb   = saros_db_open("eclipses.sdb");
+        FILE *f = fopen("eclipses.sdb", "rb");
+        if (!files || !sdb || !f) {
+            printf("container checks: no container or .db files, skipped\n\n");
+        } else {
+            int bad = 0;
+            for (int k = ECLIPSE_KIND_SOLAR; k <= ECLIPSE_KIND_LUNAR; k++) {
+                eclipse_kind_t kind = (eclipse_kind_t)k;
+                uint8_t f_first, f_last, s_first, s_last;
+                uint32_t n = saros_db_count(sdb, kind);
+                saros_db_saros_range(files, kind, &f_first, &f_last);
+                saros_db_saros_range(sdb, kind, &s_first, &s_last);
+                bad |= n != saros_db_count(files, kind);
+                bad |= f_first != s_first || f_last != s_last;
+                for (uint32_t idx = 0; idx < n; idx++) {
+                    eclipse_result_t want = saros_db_result(files, kind, idx);
+                    eclipse_result_t got  = saros_db_result(sdb, kind, idx);
+                    bad |= memcmp(&want, &got, sizeof(got)) != 0;
+                }
+            }
+
+            /* one flipped bit in the header, the table or any section, or a
+             * truncated file, and the container must not open */
+            static uint8_t image[4u << 20];
+            size_t len = fread(image, 1, sizeof(image), f);
+            uint32_t sections = len >= 64u ? (uint32_t)image[12] | (uint32_t)image[13] << 8 : 0u;
+            size_t flips[64], nflips = 0;
+            flips[nflips++] = 0;                   /* magic */
+            flips[nflips++] = 8;                   /* version */
+            flips[nflips++] = 25;                  /* header CRC */
+            flips[nflips++] = 33;                  /* solar count */
+            flips[nflips++] = 64 + 9;              /* first section offset */
+            for (uint32_t i = 0; i < sections && nflips < 64u; i++) {
+                const uint8_t *e = image + 64u + i * 32u;
+                uint64_t off = 0, size = 0;
+                for (int b = 7; b >= 0; b--) {
+                    off  = off  << 8 | e[8 + b];
+                    size = size << 8 | e[16 + b];
+                }
+                if (size > 0u)
+                    flips[nflips++] = (size_t)(off + size / 2u);
+            }
+            for (size_t i = 0; i <= nflips; i++) {
+                size_t write_len = len;
+                if (i < nflips)
+                    image[flips[i]] ^= 0x10u;
+                else
+                    write_len = len - 64u;         /* truncated */
+                int written = test_write("test_saros_lib.sdb", image, write_len);
+                if (i < nflips)
+                    image[flips[i]] ^= 0x10u;
+                if (!written) {
+                    bad = 1;
+                    break;
+                }
+                errno = 0;
+                saros_db_t *broken = saros_db_open("test_saros_lib.sdb");
+                bad |= broken != NULL || errno != EINVAL;
+                saros_db_close(broken);
+            }
+
+            /* a consistent table that leaves the solar grid without its
+             * members, emptied or handed to the lunar kind, is refused too */
+            size_t tables = 0;
+            for (uint32_t i = 0; i < sections; i++) {
+                uint8_t *e = image + 64u + i * 32u;
+                if (e[0] != ECLIPSE_KIND_SOLAR || e[1] != 10u)    /* geo members */
+                    continue;
+                uint8_t entry[32], crc[4];
+                memcpy(entry, e, sizeof(entry));
+                memcpy(crc, image + 24, sizeof(crc));
+                for (int edit = 0; edit < 2; edit++) {
+                    if (edit == 0)
+                        memset(e + 4, 0, 20);     /* CRC, offset and size: empty */
+                    else
+                        e[0] = ECLIPSE_KIND_LUNAR;
+                    test_reseal(image, sections);
+                    int written = test_write("test_saros_lib.sdb", image, len);
+                    memcpy(e, entry, sizeof(entry));
+                    memcpy(image + 24, crc, sizeof(crc));
+                    if (!written) {
+                        bad = 1;
+                        break;
+                    }
+                    errno = 0;
+                    saros_db_t *broken = saros_db_open("test_saros_lib.sdb");
+                    bad |= broken != NULL || errno != EINVAL;
+                    saros_db_close(broken);
+                    tables++;
+                }
+            }
+            remove("test_saros_lib.sdb");
+            printf("container vs .db files, %u sections, %zu damaged copies refused: %s\n\n",
+                   sections, nflips + 1u + tables, bad ? "MISMATCH" : "ok");
+            if (bad)
+                return 1;
+        }
+        if (f)
+            fclose(f);
+        saros_db_close(files);
+        saros_db_close(sdb);
+    }
+
+    /* ── Hot swap: readers keep answering while the dataset is replaced ─── */
+    {
+        enum { READERS = 4, PROBES = 64, SWAPS = 200 };
+        static int64_t          probes[PROBES];
+        static eclipse_result_t want[PROBES];
+        static live_reader_t    readers[READERS];
+        const char *src[] = { "eclipses.sdb", "." };
+        saros_db_t *first = saros_db_open(".");
+        uint32_t n = first ? saros_db_count(first, ECLIPSE_KIND_SOLAR) : 0u;
+        saros_db_live_t *live = n ? saros_db_live_create(first) : NULL;
+        if (!live) {
+            saros_db_close(first);
+            printf("hot swap: no .db files, skipped\n\n");
+        } else {
+            for (uint32_t i = 0; i < PROBES; i++) {
+                uint32_t idx = (uint32_t)((uint64_t)i * n / PROBES);
+                probes[i] = saros_db_time(first, ECLIPSE_KIND_SOLAR, idx) + (int64_t)(i % 3u) - 1;
+                want[i]   = saros_db_find_next(first, ECLIPSE_KIND_SOLAR, probes[i]);
+            }
+            pthread_t tid[READERS];
+            atomic_int stop;
+            atomic_init(&stop, 0);
+            for (int i = 0; i < READERS; i++) {
+                readers[i] = (live_reader_t){ live, probes, want, PROBES, &stop, 0, 0 };
+                if (pthread_create(&tid[i], NULL, live_reader, &readers[i]) != 0) {
+                    printf("hot swap: pthread_create failed\n");
+                    return 1;
+                }
+            }
+            /* every tenth swap is given a failed open and must keep the data */
+            int bad = 0, swapped = 0;
+            for (int i = 0; i < SWAPS; i++) {
+                saros_db_t *next = saros_db_open(i % 10 == 9 ? "no-such-file" : src[i & 1]);
+                int rc = saros_db_live_swap(live, next);
+                bad |= rc != (next ? 0 : -1);
+                swapped += rc == 0;
+            }
+            atomic_store(&stop, 1);
+            for (int i = 0; i < READERS; i++) {
+                pthread_join(tid[i], NULL);
+                bad |= readers[i].bad || readers[i].reads == 0u;
+            }
+
+            /* a swap waits for a reader still holding the old handle */
+            uint32_t ticket;
+            const saros_db_t *held = saros_db_live_acquire(live, &ticket);
+            live_swap_t sw = { live, ".", 0, -1 };
+            atomic_init(&sw.done, 0);
+            pthread_t swapper;
+            if (pthread_create(&swapper, NULL, live_swapper, &sw) != 0) {
+                printf("hot swap: pthread_create failed\n");
+                return 1;
+            }
+            nanosleep(&(struct timespec){ 0, 50 * 1000 * 1000 }, NULL);
+            eclipse_result_t got = saros_db_find_next(held, ECLIPSE_KIND_SOLAR, probes[1]);
+            bad |= atomic_load(&sw.done) != 0;
+            bad |= memcmp(&got, &want[1], sizeof(got)) != 0;
+            saros_db_live_release(live, ticket);
+            pthread_join(swapper, NULL);
+            bad |= !atomic_load(&sw.done) || sw.rc != 0;
+            saros_db_live_destroy(live);
+
+            printf("hot swap, %d readers: %d of %d swaps published, grace period held: %s\n\n",
+                   READERS, swapped, SWAPS, bad ? "MISMATCH" : "ok");
+            if (bad)
+                return 1;
+        }
+    }
+
     return 0;
 }
@@ -0,0 +1,12 @@
+/*
+ * timeline_impl.c — Solar + lunar calls for the two-unit build.
+ *
+ * find_next_eclipse_any(), find_past_eclipse_any() and eclipse_timeline*()
+ * only call the public solar and lunar API, so this unit needs no data
+ * headers.  Compile with solar_impl.c and lunar_impl.c; saros_impl.c
+ * already contains these functions.
+ */
+
+#define SAROS_IMPL_TIMELINE
+
+#include "saros.h"
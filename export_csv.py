@@ -1,9 +1,10 @@
 #!/usr/bin/env python3
 """
-export_csv.py — Export eclipse data from binary .db files to CSV.
+export_csv.py — Export eclipse data from the binary datasets to CSV.
 
-Reads db/solar/ and db/lunar/ eclipse_times.db + eclipse_info.db,
-merges both streams sorted by date, and writes:
+Reads the times and info sections of db/eclipses.sdb, or db/solar/ and
+db/lunar/ eclipse_times.db + eclipse_info.db when there is no container or
+it is refused (with a warning), merges both streams sorted by date, and writes:
 
   saros_number, type, date, time
 
@@ -27,6 +28,7 @@ import argparse
 
 SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
 DB_DIR     = os.path.join(SCRIPT_DIR, "db")
+CONTAINER  = os.path.join(DB_DIR, "eclipses.sdb")
 
 # ── Binary layout (must match build_db.py) ───────────────────────────────────
 
@@ -34,6 +36,12 @@ TIMES_RECORD    = struct.Struct("<q")           # int64, 8 bytes
 SOLAR_INFO_REC  = struct.Struct("<hhHBBBB")     # 10 bytes
 LUNAR_INFO_REC  = struct.Struct("<HHHBBBB")     # 10 bytes
 
+# The container layout is imported from build_db.py so the two cannot drift
+sys.path.insert(0, DB_DIR)
+from build_db import (CONTAINER_MAGIC, CONTAINER_VERSION, CONTAINER_KINDS,
+                      CONTAINER_HEADER, CONTAINER_SECTION,
+                      SECTION_TIMES, SECTION_INFO)
+
 # Solar eclipse type codes (index matches ecl_type field in eclipse_info.db).
 #   A   Annular                    — Moon's disk smaller than Sun, ring of sunlight visible
 #   A+  Annular (long)             — long annular phase
@@ -125,55 +133,118 @@ def _parse_date(s):
 
 # ── DB readers ───────────────────────────────────────────────────────────────
 
-def _load_times(path):
-    """Read eclipse_times.db → list of int64 timestamps."""
-    size = os.path.getsize(path)
-    count = size // 8
+def _crc32c(data):
+    """CRC32C (Castagnoli), as build_db.py stamps the container with."""
+    crc = 0xFFFFFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x82F63B78 if crc & 1 else crc >> 1
+    return crc ^ 0xFFFFFFFF
+
+def _load_container(path):
+    """Read eclipses.sdb → {kind: (count, times bytes, info bytes)}.
+
+    The counts come from the header rather than the section sizes, and every
+    CRC is checked, so a truncated or damaged file is an error, not a shorter
+    export.  Unknown sections are skipped."""
     with open(path, "rb") as f:
         data = f.read()
+    if len(data) < CONTAINER_HEADER.size:
+        raise ValueError(f"{path}: truncated header")
+    fields = CONTAINER_HEADER.unpack_from(data)
+    magic, version, header_size, sections, entry_size, total, crc = fields[:7]
+    if magic != CONTAINER_MAGIC or version != CONTAINER_VERSION:
+        raise ValueError(f"{path}: not a version {CONTAINER_VERSION} eclipse container")
+    table_end = header_size + sections * entry_size
+    if (header_size != CONTAINER_HEADER.size or entry_size != CONTAINER_SECTION.size
+            or total != len(data) or table_end > len(data)):
+        raise ValueError(f"{path}: size mismatch")
+    if _crc32c(data[:24] + bytes(4) + data[28:table_end]) != crc:
+        raise ValueError(f"{path}: header checksum mismatch")
+
+    found = {}
+    for i in range(sections):
+        kind, sid, _, sec_crc, off, size, _, _ = \
+            CONTAINER_SECTION.unpack_from(data, header_size + i * entry_size)
+        if kind >= len(CONTAINER_KINDS) or sid not in (SECTION_TIMES, SECTION_INFO):
+            continue
+        blob = data[off:off + size]
+        if len(blob) != size or _crc32c(blob) != sec_crc:
+            raise ValueError(f"{path}: section {i} checksum mismatch")
+        found[(CONTAINER_KINDS[kind], sid)] = blob
+
+    result = {}
+    for k, kind in enumerate(CONTAINER_KINDS):
+        count = fields[8 + 4 * k]
+        times = found.get((kind, SECTION_TIMES), b"")
+        info  = found.get((kind, SECTION_INFO), b"")
+        if len(times) != count * TIMES_RECORD.size or len(info) != count * 10:
+            raise ValueError(f"{path}: {kind} sections do not hold {count} eclipses")
+        result[kind] = (count, times, info)
+    return result
+
+def _load_times(data, count):
+    """Decode count int64 timestamps → list."""
     return [TIMES_RECORD.unpack_from(data, i * 8)[0] for i in range(count)]
 
-def _load_info_solar(path, count):
-    """Read eclipse_info.db (solar layout) → list of dicts."""
+def _load_info_solar(data, count):
+    """Decode count solar info records → list of dicts."""
     records = []
-    with open(path, "rb") as f:
-        for _ in range(count):
-            raw = f.read(10)
-            _lat, _lon, _dur, saros_number, _pos, ecl_type, _alt = \
-                SOLAR_INFO_REC.unpack(raw)
-            type_name = SOLAR_TYPE_NAMES[ecl_type] \
-                if ecl_type < len(SOLAR_TYPE_NAMES) else str(ecl_type)
-            records.append({"saros_number": saros_number, "type_name": type_name})
+    for i in range(count):
+        _lat, _lon, _dur, saros_number, _pos, ecl_type, _alt = \
+            SOLAR_INFO_REC.unpack_from(data, i * 10)
+        type_name = SOLAR_TYPE_NAMES[ecl_type] \
+            if ecl_type < len(SOLAR_TYPE_NAMES) else str(ecl_type)
+        records.append({"saros_number": saros_number, "type_name": type_name})
     return records
 
-def _load_info_lunar(path, count):
-    """Read eclipse_info.db (lunar layout) → list of dicts."""
+def _load_info_lunar(data, count):
+    """Decode count lunar info records → list of dicts."""
     records = []
-    with open(path, "rb") as f:
-        for _ in range(count):
-            raw = f.read(10)
-            _pen, _par, _tot, saros_number, _pos, ecl_type, _pad = \
-                LUNAR_INFO_REC.unpack(raw)
-            type_name = LUNAR_TYPE_NAMES[ecl_type] \
-                if ecl_type < len(LUNAR_TYPE_NAMES) else str(ecl_type)
-            records.append({"saros_number": saros_number, "type_name": type_name})
+    for i in range(count):
+        _pen, _par, _tot, saros_number, _pos, ecl_type, _pad = \
+            LUNAR_INFO_REC.unpack_from(data, i * 10)
+        type_name = LUNAR_TYPE_NAMES[ecl_type] \
+            if ecl_type < len(LUNAR_TYPE_NAMES) else str(ecl_type)
+        records.append({"saros_number": saros_number, "type_name": type_name})
     return records
 
-def load_kind(kind):
-    """Load all eclipses for 'solar' or 'lunar'. Returns list of row dicts."""
+def _load_db_files(kind):
+    """Read db/<kind>/eclipse_times.db + eclipse_info.db → (count, times, info),
+    or None if they are missing."""
     d = os.path.join(DB_DIR, kind)
     times_path = os.path.join(d, "eclipse_times.db")
     info_path  = os.path.join(d, "eclipse_info.db")
     if not os.path.exists(times_path) or not os.path.exists(info_path):
-        print(f"Warning: {kind} db files not found in {d}", file=sys.stderr)
-        return []
-
-    times = _load_times(times_path)
+        return None
+    with open(times_path, "rb") as f:
+        times = f.read()
+    with open(info_path, "rb") as f:
+        info = f.read()
+    count = len(times) // TIMES_RECORD.size
+    if len(times) % TIMES_RECORD.size or len(info) != count * 10:
+        raise ValueError(f"{d}: eclipse_times.db and eclipse_info.db disagree")
+    return count, times, info
+
+def load_kind(kind, container=None):
+    """Load all eclipses for 'solar' or 'lunar'. Returns list of row dicts."""
+    if container is not None:
+        count, times_data, info_data = container[kind]
+    else:
+        loaded = _load_db_files(kind)
+        if loaded is None:
+            print(f"Warning: {kind} db files not found in {os.path.join(DB_DIR, kind)}",
+                  file=sys.stderr)
+            return []
+        count, times_data, info_data = loaded
+
+    times = _load_times(times_data, count)
     if kind == "solar":
-        infos = _load_info_solar(info_path, len(times))
+        infos = _load_info_solar(info_data, count)
         prefix = "S"
     else:
-        infos = _load_info_lunar(info_path, len(times))
+        infos = _load_info_lunar(info_data, count)
         prefix = "L"
 
     rows = []
@@ -189,7 +260,7 @@ def load_kind(kind):
 
 def main():
     parser = argparse.ArgumentParser(
-        description="Export eclipse data from binary .db files to CSV.")
+        description="Export eclipse data from the binary datasets to CSV.")
     parser.add_argument("start", nargs="?", metavar="YYYY-MM-DD",
                         help="Start date (inclusive). Omit for all data.")
     parser.add_argument("end",   nargs="?", metavar="YYYY-MM-DD",
@@ -214,9 +285,15 @@ def main():
     if ts_end is not None:
         ts_end += 86399
 
+    try:
+        container = _load_container(CONTAINER) if os.path.exists(CONTAINER) else None
+    except ValueError as e:
+        print(f"Warning: {e}; reading the .db files instead", file=sys.stderr)
+        container = None
+
     rows = []
     for kind in kinds:
-        rows.extend(load_kind(kind))
+        rows.extend(load_kind(kind, container))
 
     rows.sort(key=lambda r: r["ts"])
 